@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-referencer
+ * Created on: 16 окт 2026 г.
+ *
+ * lsp-plugins-referencer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-referencer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-referencer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_HOST_OFFLINE_H_
+#define PRIVATE_HOST_OFFLINE_H_
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ipc/IExecutor.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/plugins/referencer.h>
+
+namespace lsp
+{
+    namespace host
+    {
+        static constexpr size_t MAX_BLOCK_SIZE      = 0x2000;
+
+        /**
+         * Executor that runs submitted tasks immediately in the caller's thread.
+         * This makes the cost of background tasks a part of the processing time
+         * and keeps the results reproducible between runs.
+         */
+        class OfflineExecutor: public ipc::IExecutor
+        {
+            public:
+                virtual bool submit(ipc::ITask *task) override
+                {
+                    run_task(task);
+                    return true;
+                }
+        };
+
+        /**
+         * Port that stores the value of the control port, the audio buffer of the audio port
+         * or the mesh allocated by the caller. Audio ports are filled with noise and can be
+         * bound to the external data. Other meshes, streams, frame buffers and paths provide
+         * no data, same to the host that has no UI attached.
+         */
+        class OfflinePort: public plug::IPort
+        {
+            private:
+                float       fValue;
+                float      *vBuffer;
+                void       *pBuffer;
+                uint8_t    *pData;
+
+            public:
+                explicit OfflinePort(const meta::port_t *meta): plug::IPort(meta)
+                {
+                    fValue      = meta->start;
+                    vBuffer     = NULL;
+                    pBuffer     = NULL;
+                    pData       = NULL;
+
+                    if (meta::is_audio_port(meta))
+                    {
+                        vBuffer     = static_cast<float *>(malloc(MAX_BLOCK_SIZE * sizeof(float)));
+                        if (vBuffer != NULL)
+                        {
+                            for (size_t i=0; i<MAX_BLOCK_SIZE; ++i)
+                                vBuffer[i]  = (float(rand()) / float(RAND_MAX)) - 0.5f;
+                        }
+                        pBuffer     = vBuffer;
+                    }
+                }
+
+                OfflinePort(const OfflinePort &) = delete;
+                OfflinePort & operator = (const OfflinePort &) = delete;
+
+                virtual ~OfflinePort() override
+                {
+                    if (vBuffer != NULL)
+                    {
+                        free(vBuffer);
+                        vBuffer     = NULL;
+                    }
+                    if (pData != NULL)
+                    {
+                        free_aligned(pData);
+                        pData       = NULL;
+                    }
+                    pBuffer     = NULL;
+                }
+
+            public:
+                virtual float value() override                  { return fValue;    }
+                virtual void set_value(float value) override    { fValue = value;   }
+                virtual void *buffer() override                 { return pBuffer;   }
+
+            public:
+                void bind(float *buf)                           { pBuffer = buf;    }
+
+                plug::mesh_t *mesh()                            { return (pData != NULL) ? static_cast<plug::mesh_t *>(pBuffer) : NULL; }
+
+                bool alloc_mesh(size_t buffers, size_t items)
+                {
+                    const size_t hdr_size   = align_size(sizeof(plug::mesh_t) + sizeof(float *) * buffers, OPTIMAL_ALIGN);
+                    const size_t buf_size   = align_size(sizeof(float) * items, OPTIMAL_ALIGN);
+                    uint8_t *ptr            = alloc_aligned<uint8_t>(pData, hdr_size + buf_size * buffers);
+                    if (ptr == NULL)
+                        return false;
+
+                    plug::mesh_t *mesh      = advance_ptr_bytes<plug::mesh_t>(ptr, hdr_size);
+                    for (size_t i=0; i<buffers; ++i)
+                        mesh->pvData[i]         = advance_ptr_bytes<float>(ptr, buf_size);
+                    mesh->cleanup();
+
+                    pBuffer                 = mesh;
+                    return true;
+                }
+        };
+
+        class OfflineWrapper: public plug::IWrapper
+        {
+            private:
+                OfflineExecutor    *pExecutor;
+
+            public:
+                explicit OfflineWrapper(plug::Module *plugin, OfflineExecutor *executor): plug::IWrapper(plugin, NULL)
+                {
+                    pExecutor   = executor;
+                }
+
+            public:
+                virtual ipc::IExecutor *executor() override { return pExecutor; }
+        };
+
+        /**
+         * Instance of the referencer plugin with all ports bound to the offline ports
+         */
+        class OfflineHost
+        {
+            private:
+                plugins::referencer        *pPlugin;
+                OfflineWrapper             *pWrapper;
+                OfflineExecutor             sExecutor;
+                lltl::parray<OfflinePort>   vPorts;
+
+            public:
+                OfflineHost()
+                {
+                    pPlugin     = NULL;
+                    pWrapper    = NULL;
+                }
+
+                OfflineHost(const OfflineHost &) = delete;
+                OfflineHost & operator = (const OfflineHost &) = delete;
+
+                ~OfflineHost()
+                {
+                    destroy();
+                }
+
+            public:
+                bool init(const meta::plugin_t *meta)
+                {
+                    pPlugin         = new plugins::referencer(meta);
+                    if (pPlugin == NULL)
+                        return false;
+                    pWrapper        = new OfflineWrapper(pPlugin, &sExecutor);
+                    if (pWrapper == NULL)
+                        return false;
+
+                    for (const meta::port_t *port = meta->ports; port->id != NULL; ++port)
+                    {
+                        OfflinePort *p  = new OfflinePort(port);
+                        if ((p == NULL) || (!vPorts.add(p)))
+                        {
+                            delete p;
+                            return false;
+                        }
+                    }
+
+                    pPlugin->init(pWrapper, reinterpret_cast<plug::IPort **>(vPorts.array()));
+                    return true;
+                }
+
+                void destroy()
+                {
+                    if (pPlugin != NULL)
+                    {
+                        pPlugin->destroy();
+                        delete pPlugin;
+                        pPlugin         = NULL;
+                    }
+                    if (pWrapper != NULL)
+                    {
+                        delete pWrapper;
+                        pWrapper        = NULL;
+                    }
+                    for (size_t i=0, n=vPorts.size(); i<n; ++i)
+                        delete vPorts.uget(i);
+                    vPorts.flush();
+                }
+
+                inline plugins::referencer *plugin()            { return pPlugin;               }
+                inline size_t ports() const                     { return vPorts.size();         }
+                inline OfflinePort *port(size_t index)          { return vPorts.get(index);     }
+
+                OfflinePort *port(const char *id)
+                {
+                    for (size_t i=0, n=vPorts.size(); i<n; ++i)
+                    {
+                        OfflinePort *p  = vPorts.uget(i);
+                        if (!strcmp(p->metadata()->id, id))
+                            return p;
+                    }
+                    return NULL;
+                }
+        };
+
+    } /* namespace host */
+} /* namespace lsp */
+
+#endif /* PRIVATE_HOST_OFFLINE_H_ */
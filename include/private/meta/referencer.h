@@ -45,9 +45,13 @@ namespace lsp
             static constexpr size_t AUDIO_SAMPLES               = 4;                    // Number of samples
             static constexpr size_t AUDIO_LOOPS                 = 4;                    // Number of loops per sample
             static constexpr size_t FILE_MESH_SIZE              = 640;                  // Audio file mesh size
+            static constexpr size_t PEAK_BLOCK_SIZE             = 256;                  // Number of samples per peak at the first level of the peak pyramid
+            static constexpr size_t PEAK_LEVELS_MAX             = 32;                   // Maximum number of levels in the peak pyramid
             static constexpr size_t DYNA_MESH_SIZE              = 640;                  // Dynamics graph mesh size
             static constexpr size_t DYNA_SUBSAMPLING            = 64;                   // Dynamics graph mesh sub-sampling
             static constexpr size_t WAVE_MESH_SIZE              = 640;                  // Waveform graph mesh size
+            static constexpr size_t WAVE_PEAK_BLOCK_SIZE        = 64;                   // Number of samples per peak at the first level of the waveform peak tree
+            static constexpr size_t WAVE_PEAK_LEVELS_MAX        = 16;                   // Maximum number of levels in the waveform peak tree
             static constexpr size_t FLT_BANDS                   = 6;                    // Number of post-filter bands
             static constexpr size_t FLT_SPLITS                  = FLT_BANDS - 1;        // Number of post-filter frequency splits
             static constexpr size_t EQ_RANK                     = 12;                   // Equalizer rank
@@ -65,6 +69,7 @@ namespace lsp
             static constexpr size_t PSR_MESH_SIZE               = 360;                  // Size of PSR mesh
             static constexpr float  PSR_TRUE_PEAK_DECAY         = -0.5f;                // True peak decay for PSR (see AES Convention 143 Brief 373 for reference)
             static constexpr float  AUTOGAIN_MEASURE_PERIOD     = 3000.0f;              // Measurement period for Autogain
+            static constexpr size_t AUTOGAIN_STEP               = 32;                   // Number of samples between gain matching control points
             static constexpr float  WAVE_SRANGE_DIFF_MIN        = 12.0f;                // 12 dB minimum difference on logarithmic scale
 
             static constexpr float  PEAK_HOLD_TIME              = 5000.0f;              // 5 seconds hold time for peaks
@@ -85,6 +90,11 @@ namespace lsp
             static constexpr float  LOOP_END_DFL                = SAMPLE_LENGTH_MAX;    // Default loop end position (s)
             static constexpr float  LOOP_END_STEP               = SAMPLE_LENGTH_STEP;   // Loop end position step (s)
 
+            static constexpr size_t SAMPLE_ORIGIN_MIN           = 0;                    // Sample is not loaded
+            static constexpr size_t SAMPLE_ORIGIN_MAX           = 3;                    // Sample is shared with another instance of the plugin
+            static constexpr size_t SAMPLE_ORIGIN_DFL           = SAMPLE_ORIGIN_MIN;    // Default sample origin
+            static constexpr size_t SAMPLE_ORIGIN_STEP          = 1;                    // Sample origin step
+
             static constexpr float  SAMPLE_PLAYBACK_MIN         = -1.0f;                // Minimum playback position (s)
             static constexpr float  SAMPLE_PLAYBACK_MAX         = 1000.0f;              // Maximum playback posotion (s)
             static constexpr float  SAMPLE_PLAYBACK_DFL         = -1.0f;                // Default playback position (s)
@@ -100,6 +110,16 @@ namespace lsp
             static constexpr size_t LOOP_SELECTOR_DFL           = LOOP_SELECTOR_MIN;    // Default loop selector
             static constexpr size_t LOOP_SELECTOR_STEP          = 1;                    // Sample loop step
 
+            static constexpr size_t RAM_BUDGET_MIN              = 64;                   // Minimum RAM budget for samples (MB)
+            static constexpr size_t RAM_BUDGET_MAX              = 16384;                // Maximum RAM budget for samples (MB)
+            static constexpr size_t RAM_BUDGET_DFL              = 2048;                 // Default RAM budget for samples (MB)
+            static constexpr size_t RAM_BUDGET_STEP             = 64;                   // RAM budget step (MB)
+
+            static constexpr size_t CACHE_BUDGET_MIN            = 0;                    // Minimum disk cache budget, disables the cache (MB)
+            static constexpr size_t CACHE_BUDGET_MAX            = 65536;                // Maximum disk cache budget (MB)
+            static constexpr size_t CACHE_BUDGET_DFL            = 0;                    // Default disk cache budget, the cache is disabled (MB)
+            static constexpr size_t CACHE_BUDGET_STEP           = 256;                  // Disk cache budget step (MB)
+
             static constexpr float  POST_SUB_BASS_MIN           = 20.0f;                // Sub-bass minimium frequency
             static constexpr float  POST_SUB_BASS_MAX           = 80.0f;                // Sub-bass maximium frequency
             static constexpr float  POST_SUB_BASS_DFL           = 60.0f;                // Sub-bass default frequency
@@ -134,6 +154,8 @@ namespace lsp
             static constexpr size_t FFT_RANK_DFL                = 12;                   // Default FFT rank
             static constexpr size_t FFT_RANK_MAX                = 14;                   // Maximum FFT rank
 
+            static constexpr size_t FFT_REFRESH_DFL             = 3;                    // Default FFT refresh rate (20 Hz)
+
             static constexpr float  FFT_REACT_TIME_MIN          = 0.000f;               // Spectrum analysis reactivity min
             static constexpr float  FFT_REACT_TIME_MAX          = 10.000f;              // Spectrum analysis reactivity max
             static constexpr float  FFT_REACT_TIME_DFL          = 1.000f;               // Spectrum analysis reactivity default value
@@ -209,6 +231,11 @@ namespace lsp
             static constexpr float  LOUD_METER_DFL              = GAIN_AMP_M_INF_DB;    // Loudness meter default
             static constexpr float  LOUD_METER_STEP             = 0.01f;                // Loudness meter step
 
+            static constexpr float  LOUD_RANGE_MIN              = 0.0f;                 // Loudness range minimum (LU)
+            static constexpr float  LOUD_RANGE_MAX              = 60.0f;                // Loudness range maximum (LU)
+            static constexpr float  LOUD_RANGE_DFL              = 0.0f;                 // Loudness range default (LU)
+            static constexpr float  LOUD_RANGE_STEP             = 0.01f;                // Loudness range step (LU)
+
             static constexpr float  ILUFS_TIME_MIN              = 5.0f;                 // Minimum integrated LUFS computation time
             static constexpr float  ILUFS_TIME_MAX              = 60.0f;                // Maximum integrated LUFS computation time
             static constexpr float  ILUFS_TIME_DFL              = 20.0f;                // Integrated LUFS default computation time
@@ -239,6 +266,13 @@ namespace lsp
             static constexpr float  WAVE_SMAX_SCALE_DFL         = 0.0f;                 // Default waveform mesh range end value
             static constexpr float  WAVE_SMAX_SCALE_STEP        = 0.02f;                // Default waveform mesh range step
 
+            static constexpr float  PROFILE_PERIOD              = 0.5f;                 // Period of profiling meters update (s)
+
+            static constexpr float  PROFILE_LOAD_MIN            = 0.0f;                 // Minimum processing stage load (%)
+            static constexpr float  PROFILE_LOAD_MAX            = 100.0f;               // Maximum processing stage load (%)
+            static constexpr float  PROFILE_LOAD_DFL            = 0.0f;                 // Default processing stage load (%)
+            static constexpr float  PROFILE_LOAD_STEP           = 0.01f;                // Processing stage load step (%)
+
             enum tabs_t
             {
                 TAB_OVERVIEW,
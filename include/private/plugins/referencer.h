@@ -22,8 +22,10 @@
 #ifndef PRIVATE_PLUGINS_REFERENCER_H_
 #define PRIVATE_PLUGINS_REFERENCER_H_
 
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/dsp-units/ctl/Bypass.h>
 #include <lsp-plug.in/dsp-units/filters/Equalizer.h>
+#include <lsp-plug.in/dsp-units/filters/Filter.h>
 #include <lsp-plug.in/dsp-units/meters/Correlometer.h>
 #include <lsp-plug.in/dsp-units/meters/ILUFSMeter.h>
 #include <lsp-plug.in/dsp-units/meters/LoudnessMeter.h>
@@ -32,11 +34,17 @@
 #include <lsp-plug.in/dsp-units/meters/PeakMeter.h>
 #include <lsp-plug.in/dsp-units/sampling/Sample.h>
 #include <lsp-plug.in/dsp-units/stat/QuantizedCounter.h>
+#include <lsp-plug.in/dsp-units/util/Blink.h>
 #include <lsp-plug.in/dsp-units/util/Delay.h>
 #include <lsp-plug.in/dsp-units/util/RawRingBuffer.h>
 #include <lsp-plug.in/dsp-units/util/ScaledMeterGraph.h>
 #include <lsp-plug.in/dsp-units/util/Sidechain.h>
+#include <lsp-plug.in/io/NativeFile.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+#include <lsp-plug.in/lltl/parray.h>
 #include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/runtime/LSPString.h>
 #include <private/meta/referencer.h>
 
 namespace lsp
@@ -57,6 +65,37 @@ namespace lsp
                     PB_ACTIVE,                                                      // Sample is playing
                 };
 
+                enum sample_origin_t
+                {
+                    SO_NONE,                                                        // Sample is not loaded
+                    SO_DECODED,                                                     // Sample has been decoded from the file
+                    SO_DISK_CACHE,                                                  // Sample has been loaded from the disk cache
+                    SO_SHARED,                                                      // Sample is shared with another instance of the plugin
+                };
+
+                enum timeline_value_t
+                {
+                    TL_TRUE_PEAK,                                                   // True peak
+                    TL_M_LUFS,                                                      // Momentary LUFS
+                    TL_S_LUFS,                                                      // Short-term LUFS
+
+                    TL_TOTAL
+                };
+
+                enum timeline_mode_t
+                {
+                    TM_NONE             = 0,                                        // Use live metering only
+                    TM_SHOW             = 1 << 0,                                   // Show values taken from the timeline
+                    TM_SKIP             = 1 << 1                                    // Skip live metering, it is not needed at the next block
+                };
+
+                enum partial_load_t
+                {
+                    PL_NONE,                                                        // Sample data is loaded at once
+                    PL_READY,                                                       // The head of the sample data is ready for playback
+                    PL_COMMITTED,                                                   // Partially loaded sample data is used for playback
+                };
+
                 enum source_t
                 {
                     SRC_MIX,
@@ -141,6 +180,18 @@ namespace lsp
                     FT_TOTAL
                 };
 
+                enum fft_refresh_t
+                {
+                    FR_ECONOMY,                                                     // Default rate, at most 50% overlap of FFT frames
+                    FR_5HZ,                                                         // 5 Hz refresh rate
+                    FR_10HZ,                                                        // 10 Hz refresh rate
+                    FR_20HZ,                                                        // 20 Hz refresh rate
+                    FR_30HZ,                                                        // 30 Hz refresh rate
+                    FR_60HZ,                                                        // 60 Hz refresh rate
+                    FR_OVERLAP_50,                                                  // 50% overlap of FFT frames
+                    FR_OVERLAP_75                                                   // 75% overlap of FFT frames
+                };
+
                 enum psr_mode_t
                 {
                     PSR_DENSITY,
@@ -155,6 +206,39 @@ namespace lsp
                     MATCH_MIX
                 };
 
+                enum analysis_mode_t
+                {
+                    AM_INLINE,                                                      // Analysis is performed in the audio thread
+                    AM_BACKGROUND,                                                  // Analysis is performed by the background task
+                    AM_PARALLEL,                                                    // Mix and reference are analyzed by separate background tasks
+                };
+
+                enum analysis_update_t
+                {
+                    AU_SAMPLE_RATE      = 1 << 0,                                   // Sample rate has changed
+                    AU_SETTINGS         = 1 << 1,                                   // Analysis settings have changed
+                    AU_RESET_PK         = 1 << 2,                                   // Reset peak meter
+                    AU_RESET_TP         = 1 << 3,                                   // Reset true peak meter
+                    AU_RESET_LLUFS      = 1 << 4,                                   // Reset long-term LUFS meter
+                    AU_RESET_ILUFS      = 1 << 5,                                   // Reset integrated LUFS meter
+                    AU_RESET_FFT        = 1 << 6,                                   // Reset FFT minimums and maximums
+                    AU_DEMAND           = 1 << 7,                                   // Analysis demand has changed
+                    AU_RESET_PSR        = 1 << 8,                                   // Reset PSR statistics
+                };
+
+                enum analysis_demand_t
+                {
+                    AD_WAVEFORM         = 1 << 0,                                   // Waveform capture
+                    AD_LOUDNESS         = 1 << 1,                                   // RMS, momentary and short-term loudness, PSR
+                    AD_STEREO           = 1 << 2,                                   // Correlation, panorama and mid/side balance
+                    AD_SPECTRUM         = 1 << 3,                                   // Spectrum analysis
+                    AD_GONIOMETER       = 1 << 4,                                   // Goniometer stream
+
+                    AD_NONE             = 0,
+                    AD_ALL              = AD_WAVEFORM | AD_LOUDNESS | AD_STEREO | AD_SPECTRUM | AD_GONIOMETER,
+                    AD_METERS           = AD_LOUDNESS | AD_STEREO                   // Analysis required for host-visible meters
+                };
+
                 enum waveform_t
                 {
                     WF_LEFT,
@@ -167,6 +251,23 @@ namespace lsp
                     WF_STEREO = WF_TOTAL
                 };
 
+                enum profile_stage_t
+                {
+                    PS_PREPARE_REFERENCE,                                           // Preparation of the reference signal
+                    PS_GAIN_MATCHING,                                               // Gain matching
+                    PS_PRE_FILTERS,                                                 // Pre-filters
+                    PS_METERING,                                                    // Metering
+                    PS_CAPTURE,                                                     // Capture of the analysis data
+                    PS_GONIOMETER,                                                  // Goniometer
+                    PS_FFT_ANALYSIS,                                                // FFT analysis
+                    PS_MIX,                                                         // Mixing, stereo mode and bypass
+                    PS_POST_FILTERS,                                                // Post-filters
+                    PS_OUTPUT,                                                      // Output of meters and meshes
+                    PS_PROCESS,                                                     // The whole processing cycle
+
+                    PS_TOTAL
+                };
+
                 struct afile_t;
 
                 class AFLoader: public ipc::ITask
@@ -184,6 +285,64 @@ namespace lsp
                         void                    dump(dspu::IStateDumper *v) const;
                 };
 
+                class AFStreamer: public ipc::ITask
+                {
+                    private:
+                        referencer             *pLink;
+
+                    public:
+                        explicit AFStreamer(referencer *link);
+                        virtual ~AFStreamer();
+
+                    public:
+                        virtual status_t        run();
+                        void                    dump(dspu::IStateDumper *v) const;
+                };
+
+                /**
+                 * Resamples single channel of the loaded audio file. The job is processed either by
+                 * the executor or by the loader itself, whichever starts it first. The other one waits
+                 * for the result on the lock.
+                 */
+                class Resampler: public ipc::ITask
+                {
+                    private:
+                        ipc::Mutex              sLock;                              // Lock that guards the processing
+                        dspu::Sample            sSample;                            // Single channel of the sample
+                        uint32_t                nSampleRate;                        // Target sample rate
+                        status_t                nResult;                            // Result of resampling
+                        bool                    bClaimed;                           // The job has been processed or is being processed
+
+                    public:
+                        explicit Resampler();
+                        virtual ~Resampler();
+
+                    public:
+                        status_t                bind(const float *src, size_t length, size_t src_rate, size_t dst_rate);
+                        void                    unbind();
+                        status_t                process();
+                        inline const dspu::Sample *sample() const   { return &sSample; }
+                        virtual status_t        run();
+                        void                    dump(dspu::IStateDumper *v) const;
+                };
+
+                class Analyzer: public ipc::ITask
+                {
+                    private:
+                        referencer             *pLink;
+                        uint32_t                nFirst;                             // First analysis chain to process
+                        uint32_t                nCount;                             // Number of analysis chains to process
+
+                    public:
+                        explicit Analyzer(referencer *link);
+                        virtual ~Analyzer();
+
+                    public:
+                        void                    set_chains(size_t first, size_t count);
+                        virtual status_t        run();
+                        void                    dump(dspu::IStateDumper *v) const;
+                };
+
                 typedef struct asource_t
                 {
                     float               fGain;                                      // Current gain
@@ -195,6 +354,106 @@ namespace lsp
                     plug::IPort        *pFrameOffset;                               // Waveform frame offset
                 } asource_t;
 
+                typedef struct dsample_t
+                {
+                    io::NativeFile      sFile;                                      // File with planar sample data
+                    io::Path            sPath;                                      // Path to the file
+                    uint32_t            nChannels;                                  // Number of channels
+                    uint32_t            nLength;                                    // Length of each channel in samples
+                    wsize_t             nOffset;                                    // Offset of sample data in the file
+                    bool                bTemporary;                                 // Remove the file after use
+                    float              *vBuffer[meta::referencer::AUDIO_LOOPS][meta::referencer::CHANNELS_MAX];    // Prefetch buffers
+                    float              *vSeam[meta::referencer::AUDIO_LOOPS][meta::referencer::CHANNELS_MAX];      // Cross-faded loop seam buffers
+                    uint32_t            nSeamSize;                                  // Maximum size of the loop seam
+                    float              *vScratch;                                   // Temporary buffer for building loop seams
+                    uint8_t            *pData;                                      // Allocated data for buffers
+                } dsample_t;
+
+                typedef struct csample_t
+                {
+                    uint32_t            nChannels;                                  // Number of channels
+                    uint32_t            nLength;                                    // Length of each channel in samples
+                    uint32_t            nBlocks;                                    // Number of blocks in each channel
+                    int16_t            *vData[meta::referencer::CHANNELS_MAX];      // Quantized sample data
+                    float              *vScale[meta::referencer::CHANNELS_MAX];     // Scale of each block
+                    bool                bShared;                                    // The data has been published for sharing
+                    uint8_t            *pData;                                      // Allocated data
+                } csample_t;
+
+                typedef struct atimeline_t
+                {
+                    uint32_t            nChannels;                                  // Number of analyzed channels
+                    uint32_t            nFrames;                                    // Number of frames
+                    float              *vData[TL_TOTAL];                            // Values of each frame
+                    uint8_t            *pData;                                      // Allocated data
+                } atimeline_t;
+
+                typedef struct peaks_t
+                {
+                    uint32_t            nLength;                                    // Length of the sample
+                    uint32_t            nLevels;                                    // Number of levels in the pyramid
+                    uint32_t            nSize;                                      // Number of peaks per channel
+                    uint32_t            vOffset[meta::referencer::PEAK_LEVELS_MAX]; // Offset of each level
+                    float              *vData[meta::referencer::CHANNELS_MAX];      // Peak pyramid for each channel
+                    atimeline_t        *pTimeline;                                  // Precomputed analysis timeline
+                    bool                bShared;                                    // The data has been published for sharing
+                    uint8_t            *pData;                                      // Allocated data
+                } peaks_t;
+
+                typedef struct file_stats_t
+                {
+                    float               fPeak;                                      // Sample peak
+                    float               fTruePeak;                                  // True peak
+                    float               fILUFS;                                     // Integrated loudness
+                    float               fLRA;                                       // Loudness range (LU)
+                } file_stats_t;
+
+                typedef struct shared_sample_t
+                {
+                    LSPString           sKey;                                       // Unique key of the sample data
+                    dspu::Sample       *pSample;                                    // Shared sample data
+                    csample_t          *pCompact;                                   // Shared sample data in compact format
+                    peaks_t            *pPeaks;                                     // Shared peak pyramid
+                    file_stats_t        sStats;                                     // Statistics of the sample data
+                    uint32_t            nDataRefs;                                  // Number of references to the sample data
+                    uint32_t            nPeakRefs;                                  // Number of references to the peak pyramid
+                } shared_sample_t;
+
+                typedef struct cache_header_t
+                {
+                    char                vMagic[4];                                  // Magic bytes
+                    uint32_t            nVersion;                                   // Version of the cache file
+                    uint32_t            nSampleRate;                                // Sample rate
+                    uint32_t            nChannels;                                  // Number of channels
+                    uint32_t            nLength;                                    // Length of each channel in samples
+                    uint32_t            nPeaks;                                     // Number of peaks per channel
+                    file_stats_t        sStats;                                     // Statistics of the sample data
+                    uint32_t            nTimeChannels;                              // Number of channels of the analysis timeline
+                    uint32_t            nTimeFrames;                                // Number of frames of the analysis timeline
+                } cache_header_t;
+
+                typedef struct cache_file_t
+                {
+                    io::Path            sPath;                                      // Path to the cache file
+                    wssize_t            nMTime;                                     // Last modification time
+                    wsize_t             nSize;                                      // Size of the file
+                } cache_file_t;
+
+                typedef struct prefetch_t
+                {
+                    uint32_t            nHead;                                      // Read position in the prefetch buffer
+                    uint32_t            nFill;                                      // Number of prefetched samples
+                    uint32_t            nSkip;                                      // Number of samples skipped due to buffer underrun
+                    uint32_t            nTail;                                      // Write position for the pending request
+                    uint32_t            nRequest;                                   // Number of samples requested for prefetch
+                    uint32_t            nSeam;                                      // Number of seam samples requested for prefetch
+                    int32_t             nStart;                                     // Start position of prefetched loop
+                    int32_t             nEnd;                                       // End position of prefetched loop
+                    int32_t             nPos;                                       // Position of the next sample to prefetch
+                    bool                bValid;                                     // Prefetch buffer matches the loop
+                    bool                bSeam;                                      // Seam buffer is ready
+                } prefetch_t;
+
                 typedef struct loop_t
                 {
                     playback_t          nState;                                     // Playback state
@@ -203,19 +462,53 @@ namespace lsp
                     int32_t             nEnd;                                       // End position of loop
                     int32_t             nPos;                                       // Current position of loop
                     bool                bFirst;                                     // First loop (does not requre to cross-fade with tail)
+                    bool                bSeam;                                      // Seam buffer of in-memory sample is up to date
+                    prefetch_t          sPrefetch;                                  // Prefetch state for streamed sample
+                    float              *vSeam[meta::referencer::CHANNELS_MAX];      // Cross-faded loop seam for in-memory sample
 
                     plug::IPort        *pStart;                                     // Start position of loop
                     plug::IPort        *pEnd;                                       // Start position of loop
                     plug::IPort        *pPlayPos;                                   // Current play position
                 } loop_t;
 
+                typedef struct profile_t
+                {
+                    wsize_t             nTime;                                      // Time spent in the current period (ns)
+                    wsize_t             nPeak;                                      // Maximum time of single call in the current period (ns)
+                    float               fLoad;                                      // Load measured over the last period (%)
+                    float               fPeak;                                      // Maximum time of single call over the last period (us)
+
+                    plug::IPort        *pLoad;                                      // Load meter
+                } profile_t;
+
                 typedef struct afile_t
                 {
                     AFLoader           *pLoader;                                    // Audio file loader task
+                    Resampler          *vResamplers[meta::referencer::CHANNELS_MAX - 1]; // Resampling tasks for all channels except the first one
                     dspu::Sample       *pSample;                                    // Loaded sample
                     dspu::Sample       *pLoaded;                                    // New loaded sample
+                    dsample_t          *pStream;                                    // Streamed sample
+                    dsample_t          *pLoadedStream;                              // New loaded streamed sample
+                    csample_t          *pCompact;                                   // Sample in compact format
+                    csample_t          *pLoadedCompact;                             // New loaded sample in compact format
+                    peaks_t            *pPeaks;                                     // Peak pyramid of the sample
+                    peaks_t            *pLoadedPeaks;                               // Peak pyramid of the new loaded sample
+                    file_stats_t        sStats;                                     // Statistics of the sample
+                    file_stats_t        sLoadedStats;                               // Statistics of the new loaded sample
                     status_t            nStatus;                                    // Loading status
                     uint32_t            nLength;                                    // Audio sample length
+                    uint32_t            nChannels;                                  // Audio sample channels
+                    uint32_t            nOrigin;                                    // Origin of the sample data
+                    uint32_t            nLoadedOrigin;                              // Origin of the new loaded sample data
+                    size_t              nRamLimit;                                  // Maximum size of sample data kept in RAM
+                    wsize_t             nCacheLimit;                                // Maximum size of the disk cache, zero disables the cache
+                    bool                bCompact;                                   // Keep the sample data in compact format
+                    uint32_t            nLoadRate;                                  // Sample rate the new loaded sample is prepared for
+                    bool                bReload;                                    // Reload the sample data for the new sample rate
+                    bool                bReloading;                                 // The sample data is being reloaded
+                    uatomic_t           nPartial;                                   // State of the partial load
+                    uatomic_t           nProgress;                                  // Number of samples loaded by the loader
+                    uint32_t            nValid;                                     // Number of samples available for playback
                     float               fGain;                                      // Audio file gain
                     bool                bSync;                                      // Sync sample with UI
                     float              *vThumbs[meta::referencer::CHANNELS_MAX];    // List of thumbnails
@@ -224,6 +517,12 @@ namespace lsp
                     plug::IPort        *pFile;                                      // Audio file port
                     plug::IPort        *pStatus;                                    // Status of the file
                     plug::IPort        *pLength;                                    // Actual length of the file
+                    plug::IPort        *pOrigin;                                    // Origin of the sample data
+                    plug::IPort        *pPeak;                                      // Sample peak of the file
+                    plug::IPort        *pTruePeak;                                  // True peak of the file
+                    plug::IPort        *pILUFS;                                     // Integrated loudness of the file
+                    plug::IPort        *pLRA;                                       // Loudness range of the file
+                    plug::IPort        *pPLR;                                       // Peak to loudness ratio of the file
                     plug::IPort        *pMesh;                                      // Audio file mesh
                     plug::IPort        *pGain;                                      // Audio gain
                 } afile_t;
@@ -239,6 +538,7 @@ namespace lsp
                     float              *vOut;                                       // Output buffer
                     float              *vBuffer;                                    // Signal buffer
                     float              *vInBuffer;                                  // Input buffer
+                    float              *vCapture[2];                                // Captured mix and reference signal for background analysis
 
                     // Input ports
                     plug::IPort        *pIn;                                        // Input port
@@ -253,6 +553,7 @@ namespace lsp
                 typedef struct fft_meters_t
                 {
                     float              *vHistory[2];                                // History for left and right channels
+                    float              *vAnBuffer;                                  // Temporary buffer for analysis
 
                     uint32_t            nFftPeriod;                                 // FFT analysis period
                     uint32_t            nFftFrame;                                  // Current FFT frame
@@ -261,11 +562,22 @@ namespace lsp
                     fft_graph_t         vGraphs[FG_TOTAL];                          // List of graphs
                 } fft_meters_t;
 
+                typedef struct wf_peaks_t
+                {
+                    wsize_t             nCount;                                     // Overall number of processed samples
+                    uint32_t            nLevels;                                    // Number of levels in the tree
+                    uint32_t            vSize[meta::referencer::WAVE_PEAK_LEVELS_MAX];  // Number of peaks stored for each level
+                    float              *vData[meta::referencer::WAVE_PEAK_LEVELS_MAX];  // Ring buffers of signed peaks for each level
+                    float               vAcc[meta::referencer::WAVE_PEAK_LEVELS_MAX];   // Signed peak of the incomplete block of each level
+                    uint8_t            *pData;                                      // Allocated data
+                } wf_peaks_t;
+
                 typedef struct dyna_meters_t
                 {
                     dspu::Sidechain     sRMSMeter;                                  // RMS meter
                     dspu::TruePeakMeter sTPMeter[2];                                // True Peak meters
                     dspu::Delay         sPSRDelay;                                  // PSR measurement Peak delay
+                    dspu::Filter        sKFilter[2];                                // Shared K-weighting filters for loudness meters
                     dspu::LoudnessMeter sAutogainMeter;                             // Short-term LUFS meter for Autogain matching
                     dspu::LoudnessMeter sMLUFSMeter;                                // Momentary LUFS meter
                     dspu::LoudnessMeter sSLUFSMeter;                                // Short-term LUFS meter
@@ -276,13 +588,18 @@ namespace lsp
                     dspu::Panometer     sMsBalance;                                 // Mid/Side balance
                     dspu::QuantizedCounter  sPSRStats;                              // PSR statistics
                     dspu::RawRingBuffer vWaveform[WF_TOTAL];                        // Waveform history (capture)
+                    wf_peaks_t          vWfPeaks[WF_TOTAL];                         // Decimated peak trees of waveform history
                     dspu::ScaledMeterGraph  vGraphs[DM_TOTAL];                      // Output graphs
                     dspu::PeakMeter     vPeaks[PK_TOTAL];                           // Peak meters
 
                     float              *vLoudness;                                  // Measured short-term loudness
+                    float              *vAnBuffer;                                  // Temporary buffer for analysis
                     float               fGain;                                      // Current gain
                     double              fPSRLevel;                                  // Current peak value for PSR measurement
                     uint32_t            nGonioStrobe;                               // Counter for strobe signal of goniometer
+                    uint32_t            nDemand;                                    // Analysis demanded for the chain
+                    uint32_t            nNewDemand;                                 // New analysis demand to apply
+                    uint32_t            nTimeline;                                  // Timeline mode, see timeline_mode_t
 
                     plug::IPort        *pMeters[DM_TOTAL];                          // Output meters
                     plug::IPort        *pPeaks[PK_TOTAL];                           // Output peak meters
@@ -294,13 +611,18 @@ namespace lsp
                 static const float      dm_endpoints[];
                 static const float      fft_endpoints[];
 
+                static ipc::Mutex                       sSharedLock;            // Lock for the shared samples
+                static lltl::parray<shared_sample_t>    vShared;                // Samples shared between plugin instances
+                static uatomic_t                        nSharedSamples;         // Number of shared samples in floating-point format
+
             protected:
                 uint32_t            nChannels;                                  // Number of channels
                 uint32_t            nPlaySample;                                // Current sample index
                 uint32_t            nPlayLoop;                                  // Current loop index
                 uint32_t            nGainMatching;                              // Gain matching mode
-                float               fGainMatchGrow;                             // Gain matching grow time coefficient
-                float               fGainMatchFall;                             // Gain matching fall time coefficient
+                float               fGainMatchRate;                             // Gain matching rate (logarithmic per sample)
+                float               fGainMatchGrow;                             // Gain matching grow coefficient per control step
+                float               fGainMatchFall;                             // Gain matching fall coefficient per control step
                 uint32_t            nCrossfadeTime;                             // Cross-fade time in samples
                 float               fMaxTime;                                   // Maximum display time
                 stereo_mode_t       enMode;                                     // Stereo mode
@@ -308,6 +630,7 @@ namespace lsp
                 uint32_t            nFftRank;                                   // FFT rank
                 uint32_t            nFftWindow;                                 // FFT window
                 uint32_t            nFftEnvelope;                               // FFT envelope
+                uint32_t            nFftRefresh;                                // FFT refresh mode
                 float               fFftTau;                                    // FFT smooth coefficient
                 float               fFftBal;                                    // FFT ballistics coefficient
                 uint32_t            nFftSrc;                                    // FFT marker source
@@ -315,34 +638,66 @@ namespace lsp
                 uint32_t            nGonioPeriod;                               // Goniometer period
                 uint32_t            nPsrMode;                                   // PSR display mode
                 uint32_t            nPsrThresh;                                 // PSR threshold (index)
+                uint32_t            nAnalysisMode;                              // Analysis mode
+                uint32_t            nAnalysisFlags;                             // Deferred analysis updates
+                uint32_t            nMeshDemand;                                // Analysis data demanded by the UI for meshes
+                uint32_t            nCaptureHead;                               // Write position of the capture buffer
+                uint32_t            nCaptureTail;                               // Read position of the capture buffer
+                uint32_t            nCaptureFill;                               // Number of captured samples pending for analysis
+                uint32_t            nAnalysisCount;                             // Number of captured samples submitted for analysis
+                uint32_t            nCaptureOverruns;                           // Number of captured blocks dropped due to analysis overrun
+                uint32_t            nProfPeriod;                                // Profiling period in samples
+                uint32_t            nProfCounter;                               // Number of samples processed in the current profiling period
+                const loop_t       *pTimelineLoop;                              // Loop followed by the timeline
+                int32_t             nTimelinePos;                               // Expected position of the loop at the next block
+                uint32_t            nTimelineRun;                               // Length of continuous playback since the loop start or last wrap
+                float               fFftVMarkVal;                               // Vertical marker value
                 double              fPSRDecay;                                  // Peak decay for PSR measurement
                 bool                bPlay;                                      // Play
                 bool                bSyncLoopMesh;                              // Sync loop mesh
                 bool                bUpdFft;                                    // Update FFT-related data
                 bool                bFftDamping;                                // FFT damping
                 bool                bFreeze;                                    // Freeze analysis
+                bool                bProfiling;                                 // Profiling is enabled
+                bool                bRefTimeline;                               // Use precomputed analysis timeline of the reference
 
                 float              *vBuffer;                                    // Temporary buffer
+                float              *vSeamBuffer;                                // Temporary buffer for building loop seams
                 float              *vFftFreqs;                                  // FFT frequencies
                 uint16_t           *vFftInds;                                   // FFT indices
                 float              *vFftWindow;                                 // FFT window
                 float              *vFftEnvelope;                               // FFT envelope
                 float              *vPsrLevels;                                 // PSR levels
+                float              *vTimeline[TL_TOTAL];                        // Values fetched from the analysis timeline
 
                 channel_t          *vChannels;                                  // Delay channels
                 asource_t           sMix;                                       // Mix signal characteristics
                 asource_t           sRef;                                       // Reference signal characteristics
+                dspu::Blink         sOverrun;                                   // Analysis overrun indicator
                 ipc::IExecutor     *pExecutor;                                  // Executor service
+                Analyzer           *pAnalyzer;                                  // Background analysis task
+                Analyzer           *pRefAnalyzer;                               // Background analysis task for reference in parallel mode
+                AFStreamer         *pStreamer;                                  // Streaming task
                 afile_t             vSamples[meta::referencer::AUDIO_SAMPLES];  // Audio samples
                 dyna_meters_t       vDynaMeters[2];                             // Dynamic meters for mix and reference
                 fft_meters_t        vFftMeters[2];                              // FFT meters
+                profile_t           vProfile[PS_TOTAL];                         // Profiling counters of processing stages
 
                 plug::IPort        *pBypass;                                    // Bypass
                 plug::IPort        *pFreeze;                                    // Freeze analysis
+                plug::IPort        *pRamBudget;                                 // RAM budget for samples
+                plug::IPort        *pCacheBudget;                               // Disk cache budget for samples
+                plug::IPort        *pSampleStorage;                             // Sample storage format
+                plug::IPort        *pAnalysisMode;                              // Analysis mode
+                plug::IPort        *pRefTimeline;                               // Use precomputed analysis timeline of the reference
+                plug::IPort        *pAnalysisOverrun;                           // Analysis overrun indicator
                 plug::IPort        *pPlay;                                      // Play switch
                 plug::IPort        *pPlaySample;                                // Current sample index
                 plug::IPort        *pPlayLoop;                                  // Current loop index
                 plug::IPort        *pSource;                                    // Audio source
+                plug::IPort        *pSection;                                   // Tab section selector
+                plug::IPort        *pMixVisible;                                // Mix graphs visibility
+                plug::IPort        *pRefVisible;                                // Reference graphs visibility
                 plug::IPort        *pLoopMesh;                                  // Loop mesh
                 plug::IPort        *pLoopLen;                                   // Loop length
                 plug::IPort        *pLoopPos;                                   // Loop play position
@@ -370,6 +725,7 @@ namespace lsp
                 plug::IPort        *pFftDamping;                                // Enable FFT damping
                 plug::IPort        *pFftReset;                                  // Reset FFT minimum and maximum
                 plug::IPort        *pFftBallistics;                             // FFT ballistics
+                plug::IPort        *pFftRefresh;                                // FFT refresh rate
                 plug::IPort        *pFftMesh[3];                                // FFT mesh
                 plug::IPort        *pFftVMarkSrc;                               // Vertical marker source
                 plug::IPort        *pFftVMarkFreq;                              // Vertical marker frequency
@@ -378,43 +734,115 @@ namespace lsp
                 plug::IPort        *pPsrThreshold;                              // PSR threshold
                 plug::IPort        *pPsrMesh;                                   // PSR output
                 plug::IPort        *pPsrDisplay;                                // PSR display mode
+                plug::IPort        *pProfiling;                                 // Enable profiling
 
                 uint8_t            *pData;                                      // Allocated data
 
             protected:
                 static void         destroy_sample(dspu::Sample * &sample);
+                static bool         acquire_shared(afile_t *af, const LSPString *key);
+                static void         publish_shared(const LSPString *key, dspu::Sample *sample, csample_t *compact, peaks_t *peaks, const file_stats_t *stats);
+                static bool         release_shared(const void *data);
+                static void         remove_shared(size_t index);
+                static void         destroy_stream(dsample_t * &stream);
+                static void         read_stream(dsample_t *ds, float *dst, size_t channel, size_t offset, size_t count);
+                static dsample_t   *create_stream(size_t channels, size_t length, size_t seam);
+                static status_t     read_fully(io::File *fd, wsize_t pos, void *dst, size_t count);
+                static status_t     write_fully(io::File *fd, const void *src, size_t count);
+                static int          compare_cache_files(const void *a, const void *b);
+                static void         evict_cache(const io::Path *path, wsize_t limit);
+                static bool         fetch_prefetched(prefetch_t *pf, ssize_t & count);
+                static void         make_loop_seam(float *dst, const float *head, const float *tail, size_t offset, size_t count, size_t length);
                 static void         make_thumbnail(float *dst, const float *src, size_t len, size_t dst_len);
-                static void         copy_waveform(float *dst, dspu::RawRingBuffer *rb, size_t offset, size_t length, size_t dst_len);
+                static peaks_t     *create_peaks(size_t channels, size_t length);
+                static void         destroy_peaks(peaks_t * &peaks);
+                static atimeline_t *create_timeline(size_t channels, size_t frames);
+                static void         destroy_timeline(atimeline_t * &timeline);
+                static void         expand_timeline(float *dst, const float *src, size_t pos, size_t count);
+                static csample_t   *create_compact(size_t channels, size_t length);
+                static void         destroy_compact(csample_t * &compact);
+                static void         encode_compact(csample_t *cs, size_t channel, const float *src);
+                static void         decode_compact(float *dst, const csample_t *cs, size_t channel, size_t offset, size_t count, float gain);
+                static void         build_peaks(peaks_t *peaks, size_t channel, const float *src);
+                static float        get_peak(const peaks_t *peaks, size_t channel, size_t first, size_t last);
+                static void         make_peak_thumbnail(float *dst, const peaks_t *peaks, size_t channel, size_t offset, size_t len, size_t dst_len);
+                static void         render_thumbnail(float *dst, const peaks_t *peaks, const dspu::Sample *sample, size_t channel, size_t offset, size_t len, size_t dst_len);
+                static status_t     make_file_thumbnails(afile_t *af, const peaks_t *peaks, const dspu::Sample *sample);
+                static void         clear_stats(file_stats_t *stats);
+                static float        loudness_range(float *levels, size_t count);
+                static dspu::bs::channel_t channel_designation(size_t index, size_t channels);
+                static status_t     init_loudness_meter(dspu::LoudnessMeter *meter, size_t channels, float max_period, float period, dspu::bs::weighting_t weighting);
+                static status_t     init_ilufs_meter(dspu::ILUFSMeter *meter, size_t channels, float max_int_time, dspu::bs::weighting_t weighting);
+                static status_t     analyze_sample(file_stats_t *stats, const dspu::Sample *sample, size_t sample_rate);
+                static void         copy_waveform(float *dst, dspu::RawRingBuffer *rb, const wf_peaks_t *wp, size_t offset, size_t length, size_t dst_len);
+                static bool         init_wf_peaks(wf_peaks_t *wp, size_t size);
+                static void         destroy_wf_peaks(wf_peaks_t *wp);
+                static void         clear_wf_peaks(wf_peaks_t *wp);
+                static void         clear_timeline_meters(dyna_meters_t *dm);
+                static uint32_t     fft_frame_phase(uint32_t period, size_t index);
+                static void         push_wf_peaks(wf_peaks_t *wp, const float *src, size_t count);
+                static float        get_wf_peak(const wf_peaks_t *wp, wssize_t first, wssize_t last);
                 static dspu::equalizer_mode_t decode_equalizer_mode(size_t mode);
                 static void         set_loop_range(loop_t *al, ssize_t begin, ssize_t end, ssize_t limit);
+                static uint32_t     decode_analysis_demand(size_t section);
+                static status_t     get_cache_dir(io::Path *path);
 
             protected:
                 void                dump_channels(dspu::IStateDumper *v) const;
                 void                dump_asource(dspu::IStateDumper *v, const char *name, const asource_t *as) const;
                 void                dump_dyna_meters(dspu::IStateDumper *v) const;
                 void                dump_fft_meters(dspu::IStateDumper *v) const;
+                void                dump_profile(dspu::IStateDumper *v) const;
 
             protected:
                 status_t            load_file(afile_t *file);
+                status_t            resample_sample(afile_t *af, dspu::Sample *sample, size_t sample_rate);
+                status_t            spill_sample(afile_t *af, const dspu::Sample *sample);
+                status_t            compact_sample(afile_t *af, const dspu::Sample *sample);
+                status_t            stream_file(afile_t *af, const io::Path *path, size_t channels, size_t length, wsize_t offset);
+                status_t            make_cache_path(io::Path *path, const char *fname);
+                status_t            make_shared_key(LSPString *key, const char *fname, bool compact);
+                status_t            load_cached(afile_t *af, const io::Path *path, const LSPString *key);
+                status_t            save_cached(const io::Path *path, afile_t *af, const dspu::Sample *sample);
+                status_t            build_timeline(peaks_t *peaks, const dspu::Sample *sample);
                 stereo_mode_t       decode_stereo_mode(size_t mode);
                 void                unload_afile(afile_t *file);
                 void                update_playback_state();
                 void                update_loop_ranges();
                 void                preprocess_audio_channels();
                 void                process_file_requests();
+                const loop_t       *find_timeline_loop(const afile_t **file);
+                uint32_t            fetch_reference_timeline(size_t samples);
+                void                commit_file(afile_t *af, status_t code);
+                void                process_stream_requests();
+                void                stream_samples();
                 void                prepare_reference_signal(size_t samples);
                 void                mix_channels(size_t samples);
                 void                apply_pre_filters(size_t samples);
                 void                apply_post_filters(size_t samples);
                 void                apply_stereo_mode(size_t samples);
                 void                apply_gain_matching(size_t samples);
+                void                update_loop_seam(afile_t *af, loop_t *al);
+                void                update_loop_seams(afile_t *af);
+                void                render_loop_seam(float *dst, afile_t *af, loop_t *al, size_t channel, size_t offset, size_t count);
                 void                render_loop(afile_t *af, loop_t *al, size_t samples);
                 void                perform_fft_analysis(fft_meters_t *fm, const float *l, const float *r, size_t samples);
+                uint32_t            fft_period(size_t refresh, size_t fft_size) const;
                 void                process_fft_frame(fft_meters_t *fm);
                 void                process_goniometer(dyna_meters_t *dm, const float *l, const float *r, size_t samples);
                 void                perform_metering(dyna_meters_t *dm, const float *l, const float *r, size_t samples);
                 void                accumulate_fft(fft_meters_t *fm, size_t type, const float *buf);
                 void                reset_fft();
+                void                update_analysis_sample_rate();
+                void                update_analysis_settings();
+                void                request_analysis_demand(bool ui);
+                void                update_analysis_demand();
+                void                update_analysis();
+                void                capture_analysis_data(size_t samples);
+                bool                analysis_idle() const;
+                bool                acquire_analysis();
+                void                submit_analysis();
+                void                perform_background_analysis(size_t first, size_t count);
                 void                output_file_data();
                 void                output_loop_data();
                 void                output_dyna_meters();
@@ -424,7 +852,12 @@ namespace lsp
                 void                output_spectrum_analysis(size_t type);
                 void                reduce_spectrum(float *dst, const float *src);
                 void                reduce_cspectrum(float *dst, const float *src);
+                void                reduce_stereo_spectrum(float *dl, float *dr, const float *re, const float *im, size_t rank);
                 void                configure_filter(dspu::Equalizer *eq, bool enable);
+                wsize_t             profile_begin() const;
+                wsize_t             profile_end(size_t stage, wsize_t start);
+                void                reset_profile();
+                void                update_profile(size_t samples);
                 void                do_destroy();
 
             public:
@@ -445,6 +878,7 @@ namespace lsp
                 virtual void        process(size_t samples) override;
                 virtual void        dump(dspu::IStateDumper *v) const override;
                 virtual void        ui_activated() override;
+                virtual void        ui_deactivated() override;
         };
 
     } /* namespace plugins */
@@ -0,0 +1,667 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-referencer
+ * Created on: 16 окт 2026 г.
+ *
+ * lsp-plugins-referencer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-referencer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-referencer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/finally.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/host/offline.h>
+#include <private/meta/referencer.h>
+
+namespace lsp
+{
+    namespace
+    {
+        static constexpr size_t DFL_BLOCK_SIZE      = 0x400;
+        static constexpr float  METER_PERIOD        = 10.0f;                    // Period of meter readings (ms)
+
+        /**
+         * Meters of the mix chain in the same order as the meter ports
+         */
+        enum meter_type_t
+        {
+            MT_PEAK,
+            MT_TRUE_PEAK,
+            MT_RMS,
+            MT_M_LUFS,
+            MT_S_LUFS,
+            MT_L_LUFS,
+            MT_I_LUFS,
+            MT_PSR,
+            MT_CORR,
+            MT_PAN,
+            MT_MSBAL,
+
+            MT_TOTAL,
+            MT_STEREO = MT_TOTAL,
+            MT_MONO = MT_CORR
+        };
+
+        /**
+         * Spectrum graphs of the mix chain in the same order as the rows of the FFT mesh
+         */
+        enum graph_type_t
+        {
+            GT_LEFT,
+            GT_RIGHT,
+            GT_MID,
+            GT_SIDE,
+            GT_CORR,
+            GT_PAN,
+            GT_MSBAL,
+
+            GT_TOTAL,
+            GT_STEREO = GT_TOTAL,
+            GT_MONO = GT_RIGHT
+        };
+
+        static constexpr size_t FFT_MESH_BUFFERS    = 1 + 2 * GT_TOTAL;
+        static constexpr size_t FFT_MESH_ITEMS      = meta::referencer::SPC_MESH_SIZE + 4;
+        static constexpr size_t PSR_HIST_SIZE       = meta::referencer::PSR_MESH_SIZE;
+
+        enum aggregate_t
+        {
+            AG_MAX,                                                                 // Maximum value over the file
+            AG_MEAN,                                                                // Average value over the file
+            AG_LAST                                                                 // Value at the end of the file
+        };
+
+        enum format_t
+        {
+            FMT_JSON,
+            FMT_CSV
+        };
+
+        typedef struct meter_t
+        {
+            const char     *id;                                                     // Port identifier prefix
+            const char     *name;                                                   // Report field name
+            aggregate_t     aggregate;                                              // Aggregation over the file
+            bool            gain;                                                   // Report value in decibels
+        } meter_t;
+
+        static const meter_t meters[] =
+        {
+            { "pk_",        "peak",             AG_MAX,     true    },
+            { "tp_",        "true_peak",        AG_MAX,     true    },
+            { "rms_",       "rms",              AG_MAX,     true    },
+            { "mlufs_",     "m_lufs",           AG_MAX,     true    },
+            { "slufs_",     "s_lufs",           AG_MAX,     true    },
+            { "llufs_",     "l_lufs",           AG_LAST,    true    },
+            { "ilufs_",     "i_lufs",           AG_LAST,    true    },
+            { "psr_",       "psr",              AG_MEAN,    true    },
+            { "corr_",      "correlation",      AG_MEAN,    false   },
+            { "pan_",       "panorama",         AG_MEAN,    false   },
+            { "msbal_",     "msbalance",        AG_MEAN,    false   },
+            { NULL,         NULL,               AG_LAST,    false   }
+        };
+
+        static const char *graph_names[] =
+        {
+            "left",
+            "right",
+            "mid",
+            "side",
+            "correlation",
+            "panorama",
+            "msbalance"
+        };
+
+        /**
+         * Analysis report of a single file
+         */
+        typedef struct report_t
+        {
+            const char     *sPath;                                                  // Path to the file
+            status_t        nStatus;                                                // Status of the analysis
+            size_t          nChannels;                                              // Number of analyzed channels
+            size_t          nSampleRate;                                            // Sample rate of the file
+            size_t          nLength;                                                // Length of the file in samples
+            float           vMeters[MT_TOTAL];                                      // Aggregated meter values
+            size_t          nMeters;                                                // Number of meter readings taken each METER_PERIOD
+            float           fPsrAbove;                                              // Percentage of PSR readings above threshold
+            size_t          nGraphs;                                                // Number of spectrum graphs
+            size_t          nSpectrums;                                             // Number of spectrum readings
+            float          *vFreqs;                                                 // Spectrum frequencies
+            float          *vSpectrum[GT_TOTAL];                                    // Average spectrum of each graph
+            uint32_t       *vPsrHist;                                               // PSR histogram counters
+            uint8_t        *pData;                                                  // Allocated data
+        } report_t;
+
+        /**
+         * Batch of files analyzed by a single thread
+         */
+        typedef struct worker_t
+        {
+            report_t       *vReports;                                               // List of all reports
+            size_t          nReports;                                               // Number of reports
+            size_t          nFirst;                                                 // First report to process
+            size_t          nStep;                                                  // Step between processed reports
+            size_t          nBlockSize;                                             // Processing block size
+            ipc::Thread    *pThread;                                                // Thread that processes the batch
+        } worker_t;
+
+        static host::OfflinePort *find_port(host::OfflineHost *p, const char *id, const char *suffix)
+        {
+            char key[64];
+            snprintf(key, sizeof(key), "%s%s", id, suffix);
+            return p->port(key);
+        }
+
+        static void set_port(host::OfflineHost *p, const char *id, float value)
+        {
+            host::OfflinePort *tp = p->port(id);
+            if (tp != NULL)
+                tp->set_value(value);
+        }
+
+        static bool init_report(report_t *r, const char *path)
+        {
+            const size_t spc_size   = align_size(sizeof(float) * meta::referencer::SPC_MESH_SIZE, OPTIMAL_ALIGN);
+            const size_t psr_size   = align_size(sizeof(uint32_t) * PSR_HIST_SIZE, OPTIMAL_ALIGN);
+
+            r->sPath                = path;
+            r->nStatus              = STATUS_OK;
+            r->nChannels            = 0;
+            r->nSampleRate          = 0;
+            r->nLength              = 0;
+            r->nMeters              = 0;
+            r->fPsrAbove            = 0.0f;
+            r->nGraphs              = 0;
+            r->nSpectrums           = 0;
+            r->pData                = NULL;
+
+            uint8_t *ptr            = alloc_aligned<uint8_t>(r->pData, spc_size * (GT_TOTAL + 1) + psr_size);
+            if (ptr == NULL)
+                return false;
+
+            r->vFreqs               = advance_ptr_bytes<float>(ptr, spc_size);
+            for (size_t i=0; i<GT_TOTAL; ++i)
+            {
+                r->vSpectrum[i]         = advance_ptr_bytes<float>(ptr, spc_size);
+                dsp::fill_zero(r->vSpectrum[i], meta::referencer::SPC_MESH_SIZE);
+            }
+            r->vPsrHist             = advance_ptr_bytes<uint32_t>(ptr, psr_size);
+
+            dsp::fill_zero(r->vFreqs, meta::referencer::SPC_MESH_SIZE);
+            dsp::fill_zero(r->vMeters, MT_TOTAL);
+            for (size_t i=0; i<PSR_HIST_SIZE; ++i)
+                r->vPsrHist[i]          = 0;
+
+            return true;
+        }
+
+        static void destroy_report(report_t *r)
+        {
+            free_aligned(r->pData);
+            r->pData                = NULL;
+        }
+
+        static void gather_meters(report_t *r, host::OfflineHost *p, size_t count, float psr_thresh)
+        {
+            float psr           = 0.0f;
+            for (size_t i=0; i<count; ++i)
+            {
+                host::OfflinePort *tp = find_port(p, meters[i].id, "m");
+                if (tp == NULL)
+                    continue;
+
+                const float value   = tp->value();
+                if (i == MT_PSR)
+                    psr                 = dspu::gain_to_db(value);
+
+                float *dst          = &r->vMeters[i];
+                switch (meters[i].aggregate)
+                {
+                    case AG_MAX:    *dst  = (r->nMeters > 0) ? lsp_max(*dst, value) : value; break;
+                    case AG_MEAN:   *dst += value; break;
+                    case AG_LAST:
+                    default:        *dst  = value; break;
+                }
+            }
+
+            // PSR histogram uses the same levels as the PSR mesh of the plugin
+            const float delta   = (meta::referencer::PSR_MAX_LEVEL - meta::referencer::PSR_MIN_LEVEL) / (PSR_HIST_SIZE - 1);
+            const float level   = lsp_limit(psr, meta::referencer::PSR_MIN_LEVEL, meta::referencer::PSR_MAX_LEVEL);
+            const ssize_t bin   = (level - meta::referencer::PSR_MIN_LEVEL) / delta;
+            r->vPsrHist[lsp_limit(bin, ssize_t(0), ssize_t(PSR_HIST_SIZE - 1))]++;
+            if (psr >= psr_thresh)
+                r->fPsrAbove       += 1.0f;
+
+            ++r->nMeters;
+        }
+
+        static void gather_spectrum(report_t *r, plug::mesh_t *mesh)
+        {
+            if ((mesh == NULL) || (!mesh->containsData()))
+                return;
+
+            // First row contains frequencies, then graphs of the mix and graphs of the reference follow
+            dsp::copy(r->vFreqs, &mesh->pvData[0][2], meta::referencer::SPC_MESH_SIZE);
+            for (size_t i=0; i<r->nGraphs; ++i)
+                dsp::add2(r->vSpectrum[i], &mesh->pvData[i + 1][2], meta::referencer::SPC_MESH_SIZE);
+
+            ++r->nSpectrums;
+            mesh->markEmpty();
+        }
+
+        static void analyze_file(report_t *r, size_t block_size)
+        {
+            dspu::Sample sample;
+            if ((r->nStatus = sample.load_ext(r->sPath)) != STATUS_OK)
+                return;
+
+            // Files with more than two channels are analyzed by the first two channels
+            const bool stereo           = sample.channels() > 1;
+            const meta::plugin_t *meta  = (stereo) ? &meta::referencer_stereo : &meta::referencer_mono;
+            const size_t meter_count    = (stereo) ? MT_STEREO : MT_MONO;
+            r->nChannels                = (stereo) ? 2 : 1;
+            r->nSampleRate              = sample.sample_rate();
+            r->nLength                  = sample.length();
+            r->nGraphs                  = (stereo) ? GT_STEREO : GT_MONO;
+
+            host::OfflineHost p;
+            if (!p.init(meta))
+            {
+                r->nStatus      = STATUS_NO_MEM;
+                return;
+            }
+
+            // Collect audio inputs and the spectrum mesh
+            lltl::parray<host::OfflinePort> inputs;
+            for (size_t i=0, n=p.ports(); i<n; ++i)
+            {
+                host::OfflinePort *tp = p.port(i);
+                if ((meta::is_audio_in_port(tp->metadata())) && (!inputs.add(tp)))
+                {
+                    r->nStatus      = STATUS_NO_MEM;
+                    return;
+                }
+            }
+            host::OfflinePort *fft_port = p.port("fftgr");
+            if ((fft_port == NULL) || (!fft_port->alloc_mesh(FFT_MESH_BUFFERS, FFT_MESH_ITEMS)))
+            {
+                r->nStatus      = STATUS_NO_MEM;
+                return;
+            }
+
+            // Analyze the mix inline with flat spectrum envelope, the reference stays silent
+            set_port(&p, "source", 0.0f);
+            set_port(&p, "anmode", 0.0f);
+            set_port(&p, "fftenv", dspu::envelope::WHITE_NOISE);
+            const host::OfflinePort *psr_port = p.port("psrthr");
+            const float psr_thresh  = (psr_port != NULL) ? dspu::gain_to_db(psr_port->metadata()->start) : 0.0f;
+
+            // Pretend that UI is connected, otherwise the spectrum analysis is not performed
+            p.plugin()->set_sample_rate(r->nSampleRate);
+            p.plugin()->activate();
+            p.plugin()->activate_ui();
+            p.plugin()->update_settings();
+
+            // Blocks are split at the meter reading points, so the readings do not depend on the block size
+            const size_t period     = lsp_max(dspu::millis_to_samples(r->nSampleRate, METER_PERIOD), size_t(1));
+            size_t reading          = period;
+            for (size_t offset = 0; offset < r->nLength; )
+            {
+                const size_t to_do  = lsp_min(r->nLength - offset, block_size, reading - offset);
+                for (size_t i=0, n=inputs.size(); i<n; ++i)
+                    inputs.uget(i)->bind(sample.channel(lsp_min(i, r->nChannels - 1), offset));
+
+                p.plugin()->process(to_do);
+                offset             += to_do;
+
+                if ((offset >= reading) || (offset >= r->nLength))
+                {
+                    gather_meters(r, &p, meter_count, psr_thresh);
+                    reading            += period;
+                }
+                gather_spectrum(r, fft_port->mesh());
+            }
+
+            p.plugin()->deactivate_ui();
+            p.plugin()->deactivate();
+
+            // Compute averages
+            if (r->nMeters > 0)
+            {
+                const float norm    = 1.0f / r->nMeters;
+                for (size_t i=0; i<meter_count; ++i)
+                {
+                    if (meters[i].aggregate == AG_MEAN)
+                        r->vMeters[i]      *= norm;
+                }
+                r->fPsrAbove       *= 100.0f * norm;
+            }
+            if (r->nSpectrums > 0)
+            {
+                const float norm    = 1.0f / r->nSpectrums;
+                for (size_t i=0; i<r->nGraphs; ++i)
+                    dsp::mul_k2(r->vSpectrum[i], norm, meta::referencer::SPC_MESH_SIZE);
+            }
+        }
+
+        static status_t analyze_batch(void *arg)
+        {
+            worker_t *w     = static_cast<worker_t *>(arg);
+
+            // Each thread needs its own DSP context, for example to flush denormals
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            for (size_t i=w->nFirst; i<w->nReports; i += w->nStep)
+                analyze_file(&w->vReports[i], w->nBlockSize);
+
+            return STATUS_OK;
+        }
+
+        static void write_number(FILE *out, float value, bool gain, const char *null)
+        {
+            if (gain)
+                value       = dspu::gain_to_db(value);
+            if (isfinite(value))
+                fprintf(out, "%.3f", value);
+            else
+                fputs(null, out);
+        }
+
+        static void write_json_string(FILE *out, const char *s)
+        {
+            fputc('\"', out);
+            for (; *s != '\0'; ++s)
+            {
+                const uint8_t c = *s;
+                if ((c == '\"') || (c == '\\'))
+                    fprintf(out, "\\%c", c);
+                else if (c < 0x20)
+                    fprintf(out, "\\u%04x", int(c));
+                else
+                    fputc(c, out);
+            }
+            fputc('\"', out);
+        }
+
+        static void write_json_array(FILE *out, const float *v, size_t count, bool gain)
+        {
+            fputc('[', out);
+            for (size_t i=0; i<count; ++i)
+            {
+                if (i > 0)
+                    fputc(',', out);
+                write_number(out, v[i], gain, "null");
+            }
+            fputc(']', out);
+        }
+
+        static void write_json(FILE *out, const report_t *reports, size_t count)
+        {
+            const float psr_delta   = (meta::referencer::PSR_MAX_LEVEL - meta::referencer::PSR_MIN_LEVEL) / (PSR_HIST_SIZE - 1);
+
+            fputs("[\n", out);
+            for (size_t i=0; i<count; ++i)
+            {
+                const report_t *r   = &reports[i];
+
+                fputs("  {\n    \"file\": ", out);
+                write_json_string(out, r->sPath);
+                if (r->nStatus != STATUS_OK)
+                {
+                    fputs(",\n    \"error\": ", out);
+                    write_json_string(out, get_status(r->nStatus));
+                    fprintf(out, "\n  }%s\n", (i + 1 < count) ? "," : "");
+                    continue;
+                }
+
+                fprintf(out, ",\n    \"channels\": %d,\n    \"sample_rate\": %d,\n    \"duration\": %.3f",
+                    int(r->nChannels), int(r->nSampleRate), double(r->nLength) / double(r->nSampleRate));
+
+                // Meters
+                const size_t meter_count = (r->nChannels > 1) ? MT_STEREO : MT_MONO;
+                for (size_t j=0; j<meter_count; ++j)
+                {
+                    fprintf(out, ",\n    \"%s\": ", meters[j].name);
+                    write_number(out, r->vMeters[j], meters[j].gain, "null");
+                }
+
+                // PSR histogram
+                fprintf(out, ",\n    \"psr_above\": %.3f,\n    \"psr_histogram\": {\n      \"levels\": [", r->fPsrAbove);
+                for (size_t j=0; j<PSR_HIST_SIZE; ++j)
+                    fprintf(out, "%s%.3f", (j > 0) ? "," : "", meta::referencer::PSR_MIN_LEVEL + psr_delta * j);
+                fputs("],\n      \"values\": [", out);
+                const float psr_norm = (r->nMeters > 0) ? 100.0f / r->nMeters : 0.0f;
+                for (size_t j=0; j<PSR_HIST_SIZE; ++j)
+                    fprintf(out, "%s%.3f", (j > 0) ? "," : "", r->vPsrHist[j] * psr_norm);
+                fputs("]\n    }", out);
+
+                // Spectrum
+                fputs(",\n    \"spectrum\": {\n      \"frequencies\": ", out);
+                write_json_array(out, r->vFreqs, meta::referencer::SPC_MESH_SIZE, false);
+                for (size_t j=0; j<r->nGraphs; ++j)
+                {
+                    fprintf(out, ",\n      \"%s\": ", (r->nChannels > 1) ? graph_names[j] : "mono");
+                    write_json_array(out, r->vSpectrum[j], meta::referencer::SPC_MESH_SIZE, j <= GT_SIDE);
+                }
+                fprintf(out, "\n    }\n  }%s\n", (i + 1 < count) ? "," : "");
+            }
+            fputs("]\n", out);
+        }
+
+        static void write_csv(FILE *out, const report_t *reports, size_t count)
+        {
+            fputs("file,status,channels,sample_rate,duration", out);
+            for (const meter_t *m = meters; m->id != NULL; ++m)
+                fprintf(out, ",%s", m->name);
+            fputs(",psr_above\n", out);
+
+            for (size_t i=0; i<count; ++i)
+            {
+                const report_t *r   = &reports[i];
+
+                // Quote the file name
+                fputc('\"', out);
+                for (const char *s = r->sPath; *s != '\0'; ++s)
+                {
+                    if (*s == '\"')
+                        fputc('\"', out);
+                    fputc(*s, out);
+                }
+                fprintf(out, "\",%s", get_status(r->nStatus));
+                if (r->nStatus != STATUS_OK)
+                {
+                    fputc('\n', out);
+                    continue;
+                }
+
+                fprintf(out, ",%d,%d,%.3f", int(r->nChannels), int(r->nSampleRate), double(r->nLength) / double(r->nSampleRate));
+                const size_t meter_count = (r->nChannels > 1) ? MT_STEREO : MT_MONO;
+                for (size_t j=0; j<MT_TOTAL; ++j)
+                {
+                    fputc(',', out);
+                    if (j < meter_count)
+                        write_number(out, r->vMeters[j], meters[j].gain, "");
+                }
+                fprintf(out, ",%.3f\n", r->fPsrAbove);
+            }
+        }
+
+        static void usage(FILE *out, const char *cmd)
+        {
+            fprintf(out, "Usage: %s [options] file...\n", cmd);
+            fprintf(out, "Analyze audio files with the metering of the referencer plugin\n");
+            fprintf(out, "  -b size    Processing block size, default %d\n", int(DFL_BLOCK_SIZE));
+            fprintf(out, "  -f format  Report format: json (default) or csv, spectrum and PSR\n");
+            fprintf(out, "             histogram are reported in JSON format only\n");
+            fprintf(out, "  -h         Print this help message\n");
+            fprintf(out, "  -j count   Number of threads, default is the number of CPUs\n");
+            fprintf(out, "  -o file    Output file, default is standard output\n");
+        }
+
+        static int analyze(int argc, const char **argv)
+        {
+            size_t block_size   = DFL_BLOCK_SIZE;
+            size_t threads      = ipc::Thread::system_cpus();
+            format_t format     = FMT_JSON;
+            const char *output  = NULL;
+
+            // Parse arguments
+            lltl::parray<char> files;
+            for (int i=1; i<argc; ++i)
+            {
+                const char *arg     = argv[i];
+                const bool has_next = (i + 1) < argc;
+
+                if (!strcmp(arg, "-h"))
+                {
+                    usage(stdout, argv[0]);
+                    return STATUS_OK;
+                }
+                else if ((!strcmp(arg, "-b")) && (has_next))
+                    block_size      = lsp_limit(atoi(argv[++i]), 1, int(host::MAX_BLOCK_SIZE));
+                else if ((!strcmp(arg, "-f")) && (has_next))
+                {
+                    arg             = argv[++i];
+                    if (!strcmp(arg, "json"))
+                        format          = FMT_JSON;
+                    else if (!strcmp(arg, "csv"))
+                        format          = FMT_CSV;
+                    else
+                    {
+                        fprintf(stderr, "Unknown report format: %s\n", arg);
+                        return STATUS_BAD_ARGUMENTS;
+                    }
+                }
+                else if ((!strcmp(arg, "-j")) && (has_next))
+                    threads         = lsp_max(atoi(argv[++i]), 1);
+                else if ((!strcmp(arg, "-o")) && (has_next))
+                    output          = argv[++i];
+                else if (arg[0] == '-')
+                {
+                    usage(stderr, argv[0]);
+                    return STATUS_BAD_ARGUMENTS;
+                }
+                else if (!files.add(const_cast<char *>(arg)))
+                    return STATUS_NO_MEM;
+            }
+
+            if (files.size() <= 0)
+            {
+                usage(stderr, argv[0]);
+                return STATUS_BAD_ARGUMENTS;
+            }
+
+            // Prepare reports
+            const size_t count  = files.size();
+            report_t *reports   = static_cast<report_t *>(malloc(sizeof(report_t) * count));
+            if (reports == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free(reports); };
+
+            size_t initialized  = 0;
+            lsp_finally {
+                for (size_t i=0; i<initialized; ++i)
+                    destroy_report(&reports[i]);
+            };
+            for ( ; initialized < count; ++initialized)
+            {
+                if (!init_report(&reports[initialized], files.uget(initialized)))
+                    return STATUS_NO_MEM;
+            }
+
+            // Each worker processes every n-th file, the first worker runs in the current thread
+            threads             = lsp_min(threads, count);
+            worker_t *workers   = static_cast<worker_t *>(malloc(sizeof(worker_t) * threads));
+            if (workers == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free(workers); };
+
+            for (size_t i=0; i<threads; ++i)
+            {
+                worker_t *w         = &workers[i];
+                w->vReports         = reports;
+                w->nReports         = count;
+                w->nFirst           = i;
+                w->nStep            = threads;
+                w->nBlockSize       = block_size;
+                w->pThread          = NULL;
+
+                if (i == 0)
+                    continue;
+
+                // Process the batch in the current thread if the thread can not be started
+                w->pThread          = new ipc::Thread(analyze_batch, w);
+                if ((w->pThread != NULL) && (w->pThread->start() != STATUS_OK))
+                {
+                    delete w->pThread;
+                    w->pThread          = NULL;
+                }
+                if (w->pThread == NULL)
+                    analyze_batch(w);
+            }
+
+            analyze_batch(&workers[0]);
+
+            for (size_t i=1; i<threads; ++i)
+            {
+                worker_t *w         = &workers[i];
+                if (w->pThread == NULL)
+                    continue;
+                w->pThread->join();
+                delete w->pThread;
+                w->pThread          = NULL;
+            }
+
+            // Emit the report
+            FILE *out           = (output != NULL) ? fopen(output, "w") : stdout;
+            if (out == NULL)
+            {
+                fprintf(stderr, "Could not create output file: %s\n", output);
+                return STATUS_IO_ERROR;
+            }
+            lsp_finally {
+                if (out != stdout)
+                    fclose(out);
+            };
+
+            if (format == FMT_CSV)
+                write_csv(out, reports, count);
+            else
+                write_json(out, reports, count);
+
+            return STATUS_OK;
+        }
+    } /* namespace */
+} /* namespace lsp */
+
+int main(int argc, const char **argv)
+{
+    lsp::dsp::init();
+    return lsp::analyze(argc, argv);
+}
@@ -88,9 +88,33 @@ a file, and each button in a row is associated with the loop.</p>
 		<li><b>Freeze</b> - the button that stops any update of graphs.</li>
 		<li><b>Reset</b> - the button that resets minimum and maximum values on spectrum-related graphs.</li>
 	</ul>
+	<li><b>Analysis</b> - the way the metering and spectrum analysis are performed:</li>
+	<ul>
+		<li><b>Inline</b> - the analysis is performed in the audio processing thread.</li>
+		<li><b>Background</b> - the audio data is captured and analyzed by the background task, this reduces
+		the load of the audio processing thread but introduces some extra delay for the displayed data.</li>
+		<li><b>Parallel</b> - same to <b>Background</b> but the mix and the reference are analyzed by two separate
+		background tasks which can be executed simultaneously if the host provides more than one worker thread.</li>
+	</ul>
+	<li><b>Overrun</b> - the indicator next to the analysis mode that lights when the background analysis can not keep up
+	with the audio stream and the captured audio data has been dropped. The long-term and integrated loudness and the PSR
+	statistics are reset in this case since they do not cover the dropped data.</li>
+	<li><b>Precomputed</b> - the true peak, momentary and short-term loudness of the reference are taken from the data computed
+	when the audio file has been loaded instead of measuring them in the audio processing thread. The precomputed data is used
+	with the <b>Inline</b> analysis only when a single loop longer than 3 seconds is playing and no pre-filter is applied to the reference.
+	After the loop start, the change of playback position or the wrap of the loop the values are measured in the audio processing
+	thread until 3 seconds of continuous playback is reached.</li>
 	<li><b>Window</b> - the weighting window applied to the audio data before performing spectral analysis.</li>
 	<li><b>Tolerance</b> - the number of points for the spectral analysis using FFT (Fast Fourier Transform).</li>
 	<li><b>Envelope</b> - the additional envelope compensation of the signal on the spectrum-related graphs.</li>
+	<li><b>Refresh</b> - the rate of the spectral analysis:</li>
+	<ul>
+		<li><b>Economy</b> - 20 Hz refresh rate which is lowered for large FFT sizes so the subsequent FFT frames do not overlap
+		by more than 50%.</li>
+		<li><b>5 Hz</b> - <b>60 Hz</b> - the fixed refresh rate independent of the FFT size.</li>
+		<li><b>50% overlap</b>, <b>75% overlap</b> - the refresh rate depends on the FFT size, each sample of the signal
+		is analyzed by exactly two or four FFT frames.</li>
+	</ul>
 	<li><b>Reactivity</b> - the reactivity (smoothness) of the spectral analysis.</li>
 	<li><b>Damping</b> button - the button that enables damping of minimums and maximums.</li>
 	<li><b>Damping</b> knob - the knob that controls the damping speed of minimums and maximums.</li>
@@ -160,10 +184,32 @@ section allows to quickly switch to the desired tab.</p>
 <ul>
 	<li><b>Sample</b> - the sample combo group with the sample widget. Allows to select current sample and load it's contents from the file.</li>
 	<li><b>Gain</b> - allows to adjust the loudness of the loaded audio sample.</li>
+	<li><b>Peak</b>, <b>True peak</b>, <b>I-LUFS</b>, <b>LRA</b>, <b>PLR</b> - the sample peak, the true peak, the integrated loudness,
+	the loudness range and the peak to loudness ratio of the whole loaded audio file. The values are computed once when the file
+	is loaded and do not require the file to be played.</li>
 	<li><b>Loop 1</b> - <b>Loop 4</b> - buttons that allow to display the range of the selected loop.</li>
 	<li><b>Loop 1 Start</b> - <b>Loop 4 Start</b> - the start position of the corresponding loop.</li>
 	<li><b>Loop 1 End</b> - <b>Loop 4 End</b> - the end position of the corresponding loop.</li>
+	<li><b>RAM budget</b> - the amount of memory allowed to keep the loaded audio samples. The budget is equally shared
+	between all samples. Samples that do not fit into the budget are stored in the temporary directory and streamed from the disk
+	during the playback.</li>
+	<li><b>Cache budget</b> - the maximum size of the disk cache of decoded and resampled audio files. Zero value disables
+	the disk cache, the cache is disabled by default.</li>
+	<li><b>Storage</b> - the format of the loaded audio samples kept in the memory:</li>
+	<ul>
+		<li><b>Float</b> - samples are stored as 32-bit floating-point values without any loss of precision.</li>
+		<li><b>Compact</b> - samples are stored as 16-bit integer values with the individual scale for each block of 256 samples.
+		This halves the memory footprint and allows to keep longer samples in the RAM budget. The setting is applied
+		to the samples loaded after the change.</li>
+	</ul>
 </ul>
+<p>Decoded and resampled audio files are stored in the disk cache located in the cache directory of the user, for example
+<b>~/.cache/lsp-plugins/referencer</b> on Linux. Further loading of the same
+file at the same sample rate takes the data from the cache instead of decoding the file again. The least recently used
+files are removed from the cache when it's size exceeds the cache budget. Playback of large files kept in the memory in the floating-point
+format starts as soon as the beginning of the file is read from the cache, the not yet loaded part is played as silence.</p>
+<p>Audio files which are kept in the memory are shared between all instances of the plugin running in the same process.
+Loading the same file by another instance with the same storage format does not require additional memory.</p>
 
 <p>The <b>Loudness</b> tab allows to show time graph and meters for following values:</p>
 <ul>
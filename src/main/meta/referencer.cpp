@@ -27,7 +27,7 @@
 
 #define LSP_PLUGINS_REFERENCER_VERSION_MAJOR       1
 #define LSP_PLUGINS_REFERENCER_VERSION_MINOR       0
-#define LSP_PLUGINS_REFERENCER_VERSION_MICRO       8
+#define LSP_PLUGINS_REFERENCER_VERSION_MICRO       9
 
 #define LSP_PLUGINS_REFERENCER_VERSION  \
     LSP_MODULE_VERSION( \
@@ -179,6 +179,21 @@ namespace lsp
             { NULL, NULL }
         };
 
+        static const port_item_t analysis_modes[] =
+        {
+            { "Inline",         "referencer.analysis.inline"        },
+            { "Background",     "referencer.analysis.background"    },
+            { "Parallel",       "referencer.analysis.parallel"      },
+            { NULL, NULL }
+        };
+
+        static const port_item_t sample_storages[] =
+        {
+            { "Float",          "referencer.storage.float"          },
+            { "Compact",        "referencer.storage.compact"        },
+            { NULL, NULL }
+        };
+
         static const port_item_t fft_tolerance[] =
         {
             { "1024", NULL },
@@ -189,6 +204,19 @@ namespace lsp
             { NULL, NULL }
         };
 
+        static const port_item_t fft_refresh_rates[] =
+        {
+            { "Economy",        "referencer.refresh.economy"        },
+            { "5 Hz",           NULL                                },
+            { "10 Hz",          NULL                                },
+            { "20 Hz",          NULL                                },
+            { "30 Hz",          NULL                                },
+            { "60 Hz",          NULL                                },
+            { "50% overlap",    "referencer.refresh.overlap_50"     },
+            { "75% overlap",    "referencer.refresh.overlap_75"     },
+            { NULL, NULL }
+        };
+
         static const port_item_t fft_chan_selectors_mono[] =
         {
             { "Mix",                "referencer.fft.mix"            },
@@ -220,6 +248,12 @@ namespace lsp
             PATH("sf" id, name " file"), \
             STATUS("fs" id, name " load status"), \
             METER("fl" id, name " length", U_SEC, referencer::SAMPLE_LENGTH), \
+            METER("fc" id, name " origin", U_NONE, referencer::SAMPLE_ORIGIN), \
+            METER("fpk" id, name " peak", U_GAIN_AMP, referencer::LOUD_METER), \
+            METER("ftp" id, name " true peak", U_GAIN_AMP, referencer::LOUD_METER), \
+            METER("fil" id, name " integrated LUFS", U_GAIN_AMP, referencer::LOUD_METER), \
+            METER("flr" id, name " loudness range", U_DB, referencer::LOUD_RANGE), \
+            METER("fplr" id, name " peak to loudness ratio", U_GAIN_AMP, referencer::PSR_METER), \
             MESH("fm" id, name " mesh data", referencer::CHANNELS_MAX, referencer::FILE_MESH_SIZE), \
             AMP_GAIN("sg" id, name " gain", "Gain" alias, GAIN_AMP_0_DB, GAIN_AMP_P_24_DB), \
             COMBO("ls" id, name " loop selector", "Loop" alias, 0, loop_selectors), \
@@ -230,11 +264,28 @@ namespace lsp
 
         #define REF_SAMPLES \
             COMBO("ssel", "Sample Selector", "Sample selector", 0, sample_selectors), \
+            INT_CONTROL("rambud", "RAM budget for samples", "RAM budget", U_MBYTES, referencer::RAM_BUDGET), \
+            INT_CONTROL("cachbud", "Disk cache budget for samples", "Cache budget", U_MBYTES, referencer::CACHE_BUDGET), \
+            COMBO("sstor", "Sample storage format", "Storage", 0, sample_storages), \
             REF_SAMPLE("_1", "Sample 1", " 1"), \
             REF_SAMPLE("_2", "Sample 2", " 2"), \
             REF_SAMPLE("_3", "Sample 3", " 3"), \
             REF_SAMPLE("_4", "Sample 4", " 4")
 
+        #define REF_PROFILING \
+            SWITCH("prof", "Enable profiling", "Profiling", 0), \
+            METER("prfref", "Reference preparation load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfgm", "Gain matching load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfpre", "Pre-filters load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfmtr", "Metering load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfcap", "Analysis capture load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfgon", "Goniometer load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prffft", "FFT analysis load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfmix", "Mixing load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfpost", "Post-filters load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prfout", "Output load", U_PERCENT, referencer::PROFILE_LOAD), \
+            METER("prftot", "Total processing load", U_PERCENT, referencer::PROFILE_LOAD)
+
         #define REF_COMMON(tab_selectors, dfl_chan_selector, chan_selectors) \
             SWITCH("play", "Playback", "Playback", 0), \
             INT_CONTROL("pssel", "Playback sample selector", "Sample selector", U_NONE, referencer::SAMPLE_SELECTOR), \
@@ -247,6 +298,9 @@ namespace lsp
             SWITCH("minvis", "Minimum graphs visibility", "Show min", 0), \
             SWITCH("maxvis", "Maximum graphs visibility", "Show max", 0), \
             SWITCH("freeze", "Freeze graphs", "Freeze", 0), \
+            COMBO("anmode", "Analysis mode", "Analysis", 0, analysis_modes), \
+            SWITCH("reftl", "Precomputed reference analysis", "Ref timeline", 0), \
+            BLINK("anovr", "Analysis overrun"), \
             /* playback loop display */ \
             MESH("loop_m", "Active loop contents mesh data", referencer::CHANNELS_MAX, referencer::FILE_MESH_SIZE), \
             METER("loop_l", "Active loop length", U_SEC, referencer::SAMPLE_LENGTH), \
@@ -303,7 +357,8 @@ namespace lsp
             LOG_CONTROL("fftrea", "FFT Reactivity", "Reactivity", U_SEC, referencer::FFT_REACT_TIME), \
             SWITCH("fftdamp", "FFT Damping", "FFT damp", 1), \
             TRIGGER("fftrst", "FFT Reset", "FFT reset"), \
-            LOG_CONTROL("fftbal", "FFT Ballistics", "Ballistics", U_SEC, referencer::FFT_BALLISTICS)
+            LOG_CONTROL("fftbal", "FFT Ballistics", "Ballistics", U_SEC, referencer::FFT_BALLISTICS), \
+            COMBO("fftrate", "FFT Refresh rate", "FFT refresh", referencer::FFT_REFRESH_DFL, fft_refresh_rates)
 
         #define REF_COMMON_METERS(id, name) \
             METER("pk_" id, name " Peak meter", U_GAIN_AMP, referencer::LOUD_METER), \
@@ -369,6 +424,7 @@ namespace lsp
             REF_COMMON(mono_tab_selectors, 0, fft_chan_selectors_mono),
             REF_COMMON_MONO,
             REF_SAMPLES,
+            REF_PROFILING,
 
             PORTS_END
         };
@@ -381,6 +437,7 @@ namespace lsp
             REF_COMMON(stereo_tab_selectors, 2, fft_chan_selectors_stereo),
             REF_COMMON_STEREO,
             REF_SAMPLES,
+            REF_PROFILING,
 
             PORTS_END
         };
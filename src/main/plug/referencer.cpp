@@ -23,16 +23,38 @@
 #include <lsp-plug.in/common/debug.h>
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/io/Dir.h>
 #include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/runtime/system.h>
 #include <lsp-plug.in/shared/debug.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
 
 #include <private/plugins/referencer.h>
 
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif /* PLATFORM_WINDOWS */
+
 namespace lsp
 {
     namespace plugins
     {
         static constexpr size_t BUFFER_SIZE         = 0x400;
+        static constexpr size_t ANALYSIS_BUFFER_SIZE= 0x20000;
+        static constexpr size_t STREAM_BUFFER_SIZE  = 0x10000;
+        static constexpr size_t LOOP_SEAM_SIZE      = 0x800;
+        static constexpr size_t COMPACT_BLOCK_SIZE  = 0x100;
+        static constexpr size_t LOAD_CHUNK_SIZE     = 0x40000;
+        static constexpr size_t STATS_BUFFER_SIZE   = 0x1000;
+        static constexpr size_t TIMELINE_STEP       = 0x100;
+        static constexpr float LRA_BLOCK_PERIOD     = 0.1f;
+        static constexpr float LRA_ABS_GATE         = -70.0f;
+        static constexpr float LRA_REL_GATE         = -20.0f;
+        static constexpr float LRA_LOW_PERCENTILE   = 0.10f;
+        static constexpr float LRA_HIGH_PERCENTILE  = 0.95f;
+        static constexpr uint32_t CACHE_VERSION     = 4;
 
         //---------------------------------------------------------------------
         // Plugin factory
@@ -77,6 +99,132 @@ namespace lsp
             v->write("pFile", pFile);
         }
 
+        //-------------------------------------------------------------------------
+        referencer::AFStreamer::AFStreamer(referencer *link)
+        {
+            pLink       = link;
+        }
+
+        referencer::AFStreamer::~AFStreamer()
+        {
+            pLink       = NULL;
+        }
+
+        status_t referencer::AFStreamer::run()
+        {
+            pLink->stream_samples();
+            return STATUS_OK;
+        };
+
+        void referencer::AFStreamer::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pLink", pLink);
+        }
+
+        //-------------------------------------------------------------------------
+        referencer::Analyzer::Analyzer(referencer *link)
+        {
+            pLink       = link;
+            nFirst      = 0;
+            nCount      = 2;
+        }
+
+        referencer::Analyzer::~Analyzer()
+        {
+            pLink       = NULL;
+        }
+
+        status_t referencer::Analyzer::run()
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            pLink->perform_background_analysis(nFirst, nCount);
+            return STATUS_OK;
+        };
+
+        void referencer::Analyzer::set_chains(size_t first, size_t count)
+        {
+            nFirst      = first;
+            nCount      = count;
+        }
+
+        void referencer::Analyzer::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pLink", pLink);
+            v->write("nFirst", nFirst);
+            v->write("nCount", nCount);
+        }
+
+        //-------------------------------------------------------------------------
+        referencer::Resampler::Resampler()
+        {
+            nSampleRate = 0;
+            nResult     = STATUS_OK;
+            bClaimed    = false;
+        }
+
+        referencer::Resampler::~Resampler()
+        {
+            sSample.destroy();
+        }
+
+        status_t referencer::Resampler::bind(const float *src, size_t length, size_t src_rate, size_t dst_rate)
+        {
+            if (!sSample.init(1, length, length))
+                return STATUS_NO_MEM;
+            dsp::copy(sSample.channel(0), src, length);
+            sSample.set_sample_rate(src_rate);
+
+            nSampleRate = dst_rate;
+            nResult     = STATUS_OK;
+            bClaimed    = false;
+
+            return STATUS_OK;
+        }
+
+        void referencer::Resampler::unbind()
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            // Mark the job as processed in case if the executor starts it later
+            bClaimed    = true;
+            sSample.destroy();
+        }
+
+        status_t referencer::Resampler::process()
+        {
+            sLock.lock();
+            lsp_finally { sLock.unlock(); };
+
+            if (!bClaimed)
+            {
+                bClaimed    = true;
+                nResult     = sSample.resample(nSampleRate);
+            }
+
+            return nResult;
+        }
+
+        status_t referencer::Resampler::run()
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            lsp_finally { dsp::finish(&ctx); };
+
+            return process();
+        }
+
+        void referencer::Resampler::dump(dspu::IStateDumper *v) const
+        {
+            v->write_object("sSample", &sSample);
+            v->write("nSampleRate", nSampleRate);
+            v->write("nResult", nResult);
+            v->write("bClaimed", bClaimed);
+        }
+
         //---------------------------------------------------------------------
         // Implementation
 
@@ -95,6 +243,10 @@ namespace lsp
             0.5f,               // DM_MSBAL
         };
 
+        ipc::Mutex referencer::sSharedLock;
+        lltl::parray<referencer::shared_sample_t> referencer::vShared;
+        uatomic_t referencer::nSharedSamples = 0;
+
         const float referencer::fft_endpoints[] =
         {
             GAIN_AMP_M_INF_DB, GAIN_AMP_M_INF_DB, GAIN_AMP_P_24_DB,     // FG_LEFT
@@ -114,19 +266,24 @@ namespace lsp
             nPlaySample         = -1;
             nPlayLoop           = -1;
             nGainMatching       = MATCH_NONE;
+            fGainMatchRate      = 0.0f;
             fGainMatchGrow      = 1.0f;
             fGainMatchFall      = 1.0f;
             nCrossfadeTime      = 0;
             fMaxTime            = 0.0f;
             vBuffer             = NULL;
+            vSeamBuffer         = NULL;
             vFftFreqs           = NULL;
             vFftInds            = NULL;
             vFftWindow          = NULL;
             vFftEnvelope        = NULL;
             vPsrLevels          = NULL;
+            for (size_t i=0; i<TL_TOTAL; ++i)
+                vTimeline[i]        = NULL;
             nFftRank            = 0;
             nFftWindow          = -1;
             nFftEnvelope        = -1;
+            nFftRefresh         = meta::referencer::FFT_REFRESH_DFL;
             fFftTau             = 0.0f;
             fFftBal             = 0.0f;
             nFftSrc             = 0;
@@ -134,12 +291,28 @@ namespace lsp
             nGonioPeriod        = 0;
             nPsrMode            = PSR_DENSITY;
             nPsrThresh          = 0;
+            nAnalysisMode       = AM_INLINE;
+            nAnalysisFlags      = 0;
+            nMeshDemand         = AD_NONE;
+            nCaptureHead        = 0;
+            nCaptureTail        = 0;
+            nCaptureFill        = 0;
+            nAnalysisCount      = 0;
+            nCaptureOverruns    = 0;
+            nProfPeriod         = 0;
+            nProfCounter        = 0;
+            pTimelineLoop       = NULL;
+            nTimelinePos        = -1;
+            nTimelineRun        = 0;
+            fFftVMarkVal        = GAIN_AMP_M_INF_DB;
             fPSRDecay            = 0.0f;
             bPlay               = false;
             bSyncLoopMesh       = true;
             bUpdFft             = true;
             bFftDamping         = true;
             bFreeze             = false;
+            bProfiling          = false;
+            bRefTimeline        = false;
 
             for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
                 if (meta::is_audio_in_port(p))
@@ -163,11 +336,35 @@ namespace lsp
             sRef.nTransition    = 0;
             sRef.fWaveformOff   = 0.0f;
             sRef.pFrameOffset   = NULL;
+            sOverrun.construct();
+
+            for (size_t i=0; i<PS_TOTAL; ++i)
+            {
+                profile_t *p        = &vProfile[i];
+
+                p->nTime            = 0;
+                p->nPeak            = 0;
+                p->fLoad            = 0.0f;
+                p->fPeak            = 0.0f;
+                p->pLoad            = NULL;
+            }
 
             pExecutor           = NULL;
+            pAnalyzer           = NULL;
+            pRefAnalyzer        = NULL;
+            pStreamer           = NULL;
 
             pBypass             = NULL;
             pFreeze             = NULL;
+            pRamBudget          = NULL;
+            pCacheBudget        = NULL;
+            pSampleStorage      = NULL;
+            pAnalysisMode       = NULL;
+            pRefTimeline        = NULL;
+            pAnalysisOverrun    = NULL;
+            pSection            = NULL;
+            pMixVisible         = NULL;
+            pRefVisible         = NULL;
             pPlay               = NULL;
             pPlaySample         = NULL;
             pPlayLoop           = NULL;
@@ -205,6 +402,7 @@ namespace lsp
             pFftDamping         = NULL;
             pFftReset           = NULL;
             pFftBallistics      = NULL;
+            pFftRefresh         = NULL;
             for (size_t i=0; i<FT_TOTAL; ++i)
                 pFftMesh[i]         = NULL;
             pFftVMarkSrc        = NULL;
@@ -215,17 +413,30 @@ namespace lsp
             pPsrThreshold       = NULL;
             pPsrMesh            = NULL;
             pPsrDisplay         = NULL;
+            pProfiling          = NULL;
 
             for (size_t i=0; i < 2; ++i)
             {
                 dyna_meters_t *dm   = &vDynaMeters[i];
 
                 dm->vLoudness       = NULL;
+                dm->vAnBuffer       = NULL;
                 dm->fGain           = GAIN_AMP_0_DB;
                 dm->fPSRLevel        = 0.0;
                 dm->nGonioStrobe    = 0;
+                dm->nDemand         = AD_ALL;
+                dm->nNewDemand      = AD_ALL;
+                dm->nTimeline       = TM_NONE;
                 dm->pGoniometer     = NULL;
 
+                for (size_t j=0; j<WF_TOTAL; ++j)
+                {
+                    wf_peaks_t *wp      = &dm->vWfPeaks[j];
+                    wp->nCount          = 0;
+                    wp->nLevels         = 0;
+                    wp->pData           = NULL;
+                }
+
                 for (size_t i=0; i<DM_TOTAL; ++i)
                     dm->pMeters[i]      = NULL;
                 for (size_t i=0; i<PK_TOTAL; ++i)
@@ -237,6 +448,7 @@ namespace lsp
             {
                 fft_meters_t *fm    = &vFftMeters[i];
 
+                fm->vAnBuffer       = NULL;
                 fm->vHistory[0]     = NULL;
                 fm->vHistory[1]     = NULL;
 
@@ -258,10 +470,32 @@ namespace lsp
                 afile_t *af         = &vSamples[i];
 
                 af->pLoader         = NULL;
+                for (size_t j=0; j<meta::referencer::CHANNELS_MAX - 1; ++j)
+                    af->vResamplers[j]  = NULL;
                 af->pSample         = NULL;
                 af->pLoaded         = NULL;
+                af->pStream         = NULL;
+                af->pLoadedStream   = NULL;
+                af->pCompact        = NULL;
+                af->pLoadedCompact  = NULL;
+                af->pPeaks          = NULL;
+                af->pLoadedPeaks    = NULL;
+                clear_stats(&af->sStats);
+                clear_stats(&af->sLoadedStats);
                 af->nStatus         = STATUS_UNSPECIFIED;
                 af->nLength         = 0;
+                af->nChannels       = 0;
+                af->nOrigin         = SO_NONE;
+                af->nLoadedOrigin   = SO_NONE;
+                af->nRamLimit       = 0;
+                af->nCacheLimit     = 0;
+                af->bCompact        = false;
+                af->nLoadRate       = 0;
+                af->bReload         = false;
+                af->bReloading      = false;
+                af->nPartial        = PL_NONE;
+                af->nProgress       = 0;
+                af->nValid          = 0;
                 af->fGain           = GAIN_AMP_0_DB;
                 af->bSync           = false;
 
@@ -278,6 +512,23 @@ namespace lsp
                     al->nEnd            = -1;
                     al->nPos            = -1;
                     al->bFirst          = true;
+                    al->bSeam           = false;
+
+                    prefetch_t *pf      = &al->sPrefetch;
+                    pf->nHead           = 0;
+                    pf->nFill           = 0;
+                    pf->nSkip           = 0;
+                    pf->nTail           = 0;
+                    pf->nRequest        = 0;
+                    pf->nSeam           = 0;
+                    pf->nStart          = -1;
+                    pf->nEnd            = -1;
+                    pf->nPos            = -1;
+                    pf->bValid          = false;
+                    pf->bSeam           = false;
+
+                    for (size_t k=0; k < meta::referencer::CHANNELS_MAX; ++k)
+                        al->vSeam[k]        = NULL;
 
                     al->pStart          = NULL;
                     al->pEnd            = NULL;
@@ -287,6 +538,12 @@ namespace lsp
                 af->pFile           = NULL;
                 af->pStatus         = NULL;
                 af->pLength         = NULL;
+                af->pOrigin         = NULL;
+                af->pPeak           = NULL;
+                af->pTruePeak       = NULL;
+                af->pILUFS          = NULL;
+                af->pLRA            = NULL;
+                af->pPLR            = NULL;
                 af->pMesh           = NULL;
                 af->pGain           = NULL;
             }
@@ -316,18 +573,24 @@ namespace lsp
             const size_t szof_psr   = align_size(sizeof(float) * meta::referencer::PSR_MESH_SIZE, OPTIMAL_ALIGN);
             size_t szof_channels    = align_size(sizeof(channel_t) * nChannels, OPTIMAL_ALIGN);
             size_t szof_buf         = align_size(sizeof(float) * BUFFER_SIZE, OPTIMAL_ALIGN);
-            size_t szof_global_buf  = lsp_max(szof_buf * 2, szof_fft * 2 * 4);
+            size_t szof_global_buf  = lsp_max(szof_buf * 4, szof_fft * 2 * 4);
+            size_t szof_capture     = align_size(sizeof(float) * ANALYSIS_BUFFER_SIZE, OPTIMAL_ALIGN);
+            size_t szof_seam        = align_size(sizeof(float) * LOOP_SEAM_SIZE, OPTIMAL_ALIGN);
             size_t alloc            =
                 szof_channels +     // vChannels
                 szof_global_buf +   // vBuffer
+                szof_seam +         // vSeamBuffer
+                szof_global_buf*2 + // vAnBuffer
                 szof_spc +          // vFftFreqs
                 szof_ind +          // vFftInds
                 szof_fft +          // vFftWindow
                 szof_spc +          // vFftEnvelope
                 szof_psr +          // vPsrLevels
+                szof_buf * TL_TOTAL +   // vTimeline
                 nChannels * (
                     szof_buf +          // vBuffer
-                    szof_buf            // vInBuffer
+                    szof_buf +          // vInBuffer
+                    szof_capture * 2    // vCapture
                 ) +
                 2 * (               // vDynaMeters
                     szof_buf            // vLoudness
@@ -337,6 +600,9 @@ namespace lsp
                     num_graphs * (      // vGraphs
                         szof_spc * FT_TOTAL     // Curr, Min, Max
                     )
+                ) +
+                meta::referencer::AUDIO_SAMPLES * meta::referencer::AUDIO_LOOPS * (
+                    szof_seam * nChannels       // vSeam
                 );
 
             // Allocate memory-aligned data
@@ -347,11 +613,14 @@ namespace lsp
             // Initialize pointers to channels and temporary buffer
             vChannels               = advance_ptr_bytes<channel_t>(ptr, szof_channels);
             vBuffer                 = advance_ptr_bytes<float>(ptr, szof_global_buf);
+            vSeamBuffer             = advance_ptr_bytes<float>(ptr, szof_seam);
             vFftFreqs               = advance_ptr_bytes<float>(ptr, szof_spc);
             vFftInds                = advance_ptr_bytes<uint16_t>(ptr, szof_ind);
             vFftWindow              = advance_ptr_bytes<float>(ptr, szof_fft);
             vFftEnvelope            = advance_ptr_bytes<float>(ptr, szof_spc);
             vPsrLevels              = advance_ptr_bytes<float>(ptr, szof_psr);
+            for (size_t i=0; i<TL_TOTAL; ++i)
+                vTimeline[i]            = advance_ptr_bytes<float>(ptr, szof_buf);
 
             // Initialize audio channels
             for (size_t i=0; i < nChannels; ++i)
@@ -378,6 +647,8 @@ namespace lsp
                 // Initialize fields
                 c->vBuffer              = advance_ptr_bytes<float>(ptr, szof_buf);
                 c->vInBuffer            = advance_ptr_bytes<float>(ptr, szof_buf);
+                c->vCapture[0]          = advance_ptr_bytes<float>(ptr, szof_capture);
+                c->vCapture[1]          = advance_ptr_bytes<float>(ptr, szof_capture);
 
                 c->pIn                  = NULL;
                 c->pOut                 = NULL;
@@ -388,6 +659,9 @@ namespace lsp
             {
                 fft_meters_t *fm    = &vFftMeters[i];
 
+                // Each analysis chain has its own temporary buffer to allow parallel processing
+                fm->vAnBuffer       = advance_ptr_bytes<float>(ptr, szof_global_buf);
+                vDynaMeters[i].vAnBuffer    = fm->vAnBuffer;
                 fm->vHistory[0]     = advance_ptr_bytes<float>(ptr, szof_history);
                 if (nChannels > 1)
                     fm->vHistory[1]     = advance_ptr_bytes<float>(ptr, szof_history);
@@ -401,6 +675,18 @@ namespace lsp
                 }
             }
 
+            // Initialize loop seam buffers
+            for (size_t i=0; i<meta::referencer::AUDIO_SAMPLES; ++i)
+            {
+                afile_t *af         = &vSamples[i];
+                for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+                {
+                    loop_t *al          = &af->vLoops[j];
+                    for (size_t k=0; k<nChannels; ++k)
+                        al->vSeam[k]        = advance_ptr_bytes<float>(ptr, szof_seam);
+                }
+            }
+
             // Initialize dynamics meters
             for (size_t i=0; i<2; ++i)
             {
@@ -422,15 +708,20 @@ namespace lsp
                 if (!dm->sTPMeter[1].init())
                     return;
 
-                if (dm->sAutogainMeter.init(nChannels, meta::referencer::AUTOGAIN_MEASURE_PERIOD) != STATUS_OK)
+                if (init_loudness_meter(&dm->sAutogainMeter, nChannels, meta::referencer::AUTOGAIN_MEASURE_PERIOD,
+                    dspu::bs::LUFS_SHORT_TERM_PERIOD, dspu::bs::WEIGHT_K) != STATUS_OK)
                     return;
-                if (dm->sMLUFSMeter.init(nChannels, dspu::bs::LUFS_MOMENTARY_PERIOD) != STATUS_OK)
+
+                // K-weighting is performed once by the shared filters for all loudness meters
+                if (init_loudness_meter(&dm->sMLUFSMeter, nChannels, dspu::bs::LUFS_MOMENTARY_PERIOD,
+                    dspu::bs::LUFS_MOMENTARY_PERIOD, dspu::bs::WEIGHT_NONE) != STATUS_OK)
                     return;
-                if (dm->sSLUFSMeter.init(nChannels, dspu::bs::LUFS_SHORT_TERM_PERIOD) != STATUS_OK)
+                if (init_loudness_meter(&dm->sSLUFSMeter, nChannels, dspu::bs::LUFS_SHORT_TERM_PERIOD,
+                    dspu::bs::LUFS_SHORT_TERM_PERIOD, dspu::bs::WEIGHT_NONE) != STATUS_OK)
                     return;
-                if (dm->sLLUFSMeter.init(nChannels, meta::referencer::ILUFS_TIME_MAX, dspu::bs::LUFS_MOMENTARY_PERIOD) != STATUS_OK)
+                if (init_ilufs_meter(&dm->sLLUFSMeter, nChannels, meta::referencer::ILUFS_TIME_MAX, dspu::bs::WEIGHT_NONE) != STATUS_OK)
                     return;
-                if (dm->sILUFSMeter.init(nChannels, 0, dspu::bs::LUFS_MOMENTARY_PERIOD) != STATUS_OK)
+                if (init_ilufs_meter(&dm->sILUFSMeter, nChannels, 0, dspu::bs::WEIGHT_NONE) != STATUS_OK)
                     return;
 
                 for (size_t j=0; j<PK_TOTAL; ++j)
@@ -442,58 +733,11 @@ namespace lsp
 
                 dm->sPSRStats.construct();
 
-                dm->sAutogainMeter.set_period(dspu::bs::LUFS_SHORT_TERM_PERIOD);
-                dm->sAutogainMeter.set_weighting(dspu::bs::WEIGHT_K);
-                dm->sMLUFSMeter.set_period(dspu::bs::LUFS_MOMENTARY_PERIOD);
-                dm->sMLUFSMeter.set_weighting(dspu::bs::WEIGHT_K);
-                dm->sSLUFSMeter.set_period(dspu::bs::LUFS_SHORT_TERM_PERIOD);
-                dm->sSLUFSMeter.set_weighting(dspu::bs::WEIGHT_K);
-                dm->sLLUFSMeter.set_weighting(dspu::bs::WEIGHT_K);
-                dm->sILUFSMeter.set_weighting(dspu::bs::WEIGHT_K);
-
-                if (nChannels > 1)
-                {
-                    dm->sAutogainMeter.set_active(0, true);
-                    dm->sAutogainMeter.set_active(1, true);
-                    dm->sAutogainMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
-                    dm->sAutogainMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
-
-                    dm->sMLUFSMeter.set_active(0, true);
-                    dm->sMLUFSMeter.set_active(1, true);
-                    dm->sMLUFSMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
-                    dm->sMLUFSMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
-
-                    dm->sSLUFSMeter.set_active(0, true);
-                    dm->sSLUFSMeter.set_active(1, true);
-                    dm->sSLUFSMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
-                    dm->sSLUFSMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
-
-                    dm->sLLUFSMeter.set_active(0, true);
-                    dm->sLLUFSMeter.set_active(1, true);
-                    dm->sLLUFSMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
-                    dm->sLLUFSMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
-
-                    dm->sILUFSMeter.set_active(0, true);
-                    dm->sILUFSMeter.set_active(1, true);
-                    dm->sILUFSMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
-                    dm->sILUFSMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
-                }
-                else
+                for (size_t j=0; j<2; ++j)
                 {
-                    dm->sAutogainMeter.set_active(0, true);
-                    dm->sAutogainMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
-
-                    dm->sMLUFSMeter.set_active(0, true);
-                    dm->sMLUFSMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
-
-                    dm->sSLUFSMeter.set_active(0, true);
-                    dm->sSLUFSMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
-
-                    dm->sLLUFSMeter.set_active(0, true);
-                    dm->sLLUFSMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
-
-                    dm->sILUFSMeter.set_active(0, true);
-                    dm->sILUFSMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
+                    dm->sKFilter[j].construct();
+                    if (!dm->sKFilter[j].init(NULL))
+                        return;
                 }
             }
 
@@ -507,8 +751,29 @@ namespace lsp
                 af->pLoader         = new AFLoader(this, af);
                 if (af->pLoader == NULL)
                     return;
+
+                // Create resampling tasks
+                for (size_t j=0; j<meta::referencer::CHANNELS_MAX - 1; ++j)
+                {
+                    af->vResamplers[j]  = new Resampler();
+                    if (af->vResamplers[j] == NULL)
+                        return;
+                }
             }
 
+            // Create analysis task
+            pAnalyzer           = new Analyzer(this);
+            if (pAnalyzer == NULL)
+                return;
+            pRefAnalyzer        = new Analyzer(this);
+            if (pRefAnalyzer == NULL)
+                return;
+
+            // Create streaming task
+            pStreamer           = new AFStreamer(this);
+            if (pStreamer == NULL)
+                return;
+
             // Bind ports
             lsp_trace("Binding ports");
             size_t port_id      = 0;
@@ -528,13 +793,16 @@ namespace lsp
             BIND_PORT(pPlaySample);
             BIND_PORT(pPlayLoop);
             BIND_PORT(pSource);
-            SKIP_PORT("Tab section selector");
-            SKIP_PORT("Mix graph visibility");
-            SKIP_PORT("Reference graph visibility");
+            BIND_PORT(pSection);
+            BIND_PORT(pMixVisible);
+            BIND_PORT(pRefVisible);
             SKIP_PORT("Current graphs visibility");
             SKIP_PORT("Minimum graphs visibility");
             SKIP_PORT("Maximum graphs visibility");
             BIND_PORT(pFreeze);
+            BIND_PORT(pAnalysisMode);
+            BIND_PORT(pRefTimeline);
+            BIND_PORT(pAnalysisOverrun);
             BIND_PORT(pLoopMesh);
             BIND_PORT(pLoopLen);
             BIND_PORT(pLoopPos);
@@ -593,6 +861,7 @@ namespace lsp
             BIND_PORT(pFftDamping);
             BIND_PORT(pFftReset);
             BIND_PORT(pFftBallistics);
+            BIND_PORT(pFftRefresh);
 
             // Operating mode
             if (nChannels > 1)
@@ -647,6 +916,9 @@ namespace lsp
             // Bind sample-related ports
             lsp_trace("Binding sample-related ports");
             SKIP_PORT("Sample selector");
+            BIND_PORT(pRamBudget);
+            BIND_PORT(pCacheBudget);
+            BIND_PORT(pSampleStorage);
 
             for (size_t i=0; i < meta::referencer::AUDIO_SAMPLES; ++i)
             {
@@ -655,6 +927,12 @@ namespace lsp
                 BIND_PORT(af->pFile);
                 BIND_PORT(af->pStatus);
                 BIND_PORT(af->pLength);
+                BIND_PORT(af->pOrigin);
+                BIND_PORT(af->pPeak);
+                BIND_PORT(af->pTruePeak);
+                BIND_PORT(af->pILUFS);
+                BIND_PORT(af->pLRA);
+                BIND_PORT(af->pPLR);
                 BIND_PORT(af->pMesh);
                 BIND_PORT(af->pGain);
                 SKIP_PORT("Loop selector");
@@ -669,6 +947,11 @@ namespace lsp
                 }
             }
 
+            lsp_trace("Binding profiling ports");
+            BIND_PORT(pProfiling);
+            for (size_t i=0; i<PS_TOTAL; ++i)
+                BIND_PORT(vProfile[i].pLoad);
+
             // Initialize PSR levels
             const float psr_delta   = (meta::referencer::PSR_MAX_LEVEL - meta::referencer::PSR_MIN_LEVEL) / meta::referencer::PSR_MESH_SIZE;
             for (size_t i=0; i<meta::referencer::PSR_MESH_SIZE; ++i)
@@ -694,12 +977,44 @@ namespace lsp
                     delete af->pLoader;
                     af->pLoader         = NULL;
                 }
+                for (size_t j=0; j<meta::referencer::CHANNELS_MAX - 1; ++j)
+                {
+                    if (af->vResamplers[j] != NULL)
+                    {
+                        delete af->vResamplers[j];
+                        af->vResamplers[j]  = NULL;
+                    }
+                }
 
                 // Destroy audio file
                 unload_afile(af);
+                destroy_sample(af->pSample);
+                destroy_stream(af->pStream);
+                destroy_compact(af->pCompact);
+                destroy_peaks(af->pPeaks);
+            }
+
+            // Destroy analysis task
+            if (pAnalyzer != NULL)
+            {
+                delete pAnalyzer;
+                pAnalyzer           = NULL;
+            }
+            if (pRefAnalyzer != NULL)
+            {
+                delete pRefAnalyzer;
+                pRefAnalyzer        = NULL;
+            }
+
+            // Destroy streaming task
+            if (pStreamer != NULL)
+            {
+                delete pStreamer;
+                pStreamer           = NULL;
             }
 
             // Destroy meters
+            sOverrun.destroy();
             for (size_t i=0; i<2; ++i)
             {
                 dyna_meters_t *dm       = &vDynaMeters[i];
@@ -708,6 +1023,8 @@ namespace lsp
                 dm->sTPMeter[0].destroy();
                 dm->sTPMeter[1].destroy();
                 dm->sPSRDelay.destroy();
+                dm->sKFilter[0].destroy();
+                dm->sKFilter[1].destroy();
                 dm->sAutogainMeter.destroy();
                 dm->sMLUFSMeter.destroy();
                 dm->sSLUFSMeter.destroy();
@@ -718,7 +1035,10 @@ namespace lsp
                 dm->sMsBalance.destroy();
 
                 for (size_t j=0; j<WF_TOTAL; ++j)
+                {
                     dm->vWaveform[j].destroy();
+                    destroy_wf_peaks(&dm->vWfPeaks[j]);
+                }
 
                 for (size_t j=0; j<DM_TOTAL; ++j)
                     dm->vGraphs[j].destroy();
@@ -753,9 +1073,7 @@ namespace lsp
         {
             // Update cross-fade time and sync it with playbacks
             nCrossfadeTime      = dspu::millis_to_samples(fSampleRate, meta::referencer::CROSSFADE_TIME);
-            bUpdFft             = true;
-            const double tpd    = double(meta::referencer::PSR_TRUE_PEAK_DECAY * 0.1 * M_LN10) / double(sr);
-            fPSRDecay            = exp(tpd);
+            sOverrun.init(sr);
 
             sMix.fGain          = sMix.fNewGain;
             sMix.fOldGain       = sMix.fNewGain;
@@ -768,16 +1086,30 @@ namespace lsp
             for (size_t i=0; i<meta::referencer::AUDIO_SAMPLES; ++i)
             {
                 afile_t *af             = &vSamples[i];
+
+                // Loaded sample data is resampled to the previous sample rate, reload it in background
+                if (af->nLength > 0)
+                    af->bReload             = true;
+
                 for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
                 {
                     loop_t *al              = &af->vLoops[j];
                     al->nTransition         = lsp_min(al->nTransition, nCrossfadeTime);
+
+                    // Loop seams depend on the cross-fade time, prefetch the data again
+                    al->sPrefetch.bValid    = false;
+                    al->sPrefetch.bSeam     = false;
+                    al->bSeam               = false;
                 }
             }
 
             // Update goniometer settings
             nGonioPeriod        = dspu::hz_to_samples(fSampleRate, meta::referencer::GONIO_REFRESH_RATE);
 
+            // Update profiling settings
+            nProfPeriod         = dspu::seconds_to_samples(fSampleRate, meta::referencer::PROFILE_PERIOD);
+            reset_profile();
+
             // Update sample rate for the bypass processors
             for (size_t i=0; i < nChannels; ++i)
             {
@@ -788,14 +1120,37 @@ namespace lsp
                 c->sPostFilter.set_sample_rate(sr);
             }
 
+            // Update gain matching meters
+            for (size_t i=0; i<2; ++i)
+            {
+                dyna_meters_t *dm       = &vDynaMeters[i];
+
+                dm->sAutogainMeter.set_sample_rate(sr);
+                dm->nGonioStrobe        = nGonioPeriod;
+            }
+
+            // Update analysis, defer the update if the analysis task is currently running
+            nAnalysisFlags     |= AU_SAMPLE_RATE;
+            if (analysis_idle())
+                update_analysis();
+        }
+
+        void referencer::update_analysis_sample_rate()
+        {
+            const size_t sr     = fSampleRate;
+
+            bUpdFft             = true;
+            const double tpd    = double(meta::referencer::PSR_TRUE_PEAK_DECAY * 0.1 * M_LN10) / double(sr);
+            fPSRDecay            = exp(tpd);
+
             // Cleanup FFT buffers
             const size_t num_graphs = (nChannels > 1) ? FG_TOTAL : 1;
             for (size_t i=0; i < 2; ++i)
             {
                 fft_meters_t *fm    = &vFftMeters[i];
 
-                fm->nFftPeriod      = dspu::hz_to_samples(fSampleRate, meta::referencer::SPC_REFRESH_RATE);
-                fm->nFftFrame       = 0;
+                fm->nFftPeriod      = fft_period(nFftRefresh, 1 << nFftRank);
+                fm->nFftFrame       = fft_frame_phase(fm->nFftPeriod, i);
                 fm->nFftHistory     = 0;
 
                 for (size_t j=0; j < num_graphs; ++j)
@@ -819,6 +1174,14 @@ namespace lsp
             const size_t max_psr_period = dspu::seconds_to_samples(sr, meta::referencer::PSR_PERIOD_MAX);
             const size_t dmesh_period   = dspu::seconds_to_samples(sr, meta::referencer::DYNA_TIME_MAX / meta::referencer::DYNA_MESH_SIZE);
 
+            dspu::filter_params_t fp;
+            fp.nType                    = dspu::FLT_K_WEIGHTED;
+            fp.fFreq                    = 0.0f;
+            fp.fFreq2                   = 0.0f;
+            fp.fGain                    = GAIN_AMP_0_DB;
+            fp.nSlope                   = 0;
+            fp.fQuality                 = 0.0f;
+
             for (size_t i=0; i<2; ++i)
             {
                 dyna_meters_t *dm       = &vDynaMeters[i];
@@ -827,7 +1190,12 @@ namespace lsp
                 dm->sTPMeter[0].set_sample_rate(sr);
                 dm->sTPMeter[1].set_sample_rate(sr);
 
-                dm->sAutogainMeter.set_sample_rate(sr);
+                for (size_t j=0; j<2; ++j)
+                {
+                    dm->sKFilter[j].update(sr, &fp);
+                    dm->sKFilter[j].clear();
+                }
+
                 dm->sMLUFSMeter.set_sample_rate(sr);
                 dm->sSLUFSMeter.set_sample_rate(sr);
                 dm->sLLUFSMeter.set_sample_rate(sr);
@@ -860,7 +1228,10 @@ namespace lsp
                     meta::referencer::PSR_MESH_SIZE);
 
                 for (size_t j=0; j<WF_TOTAL; ++j)
+                {
                     dm->vWaveform[j].init(max_wf_len + BUFFER_SIZE);
+                    init_wf_peaks(&dm->vWfPeaks[j], max_wf_len + BUFFER_SIZE);
+                }
 
                 for (size_t j=0; j<DM_TOTAL; ++j)
                     dm->vGraphs[j].init(meta::referencer::DYNA_MESH_SIZE, meta::referencer::DYNA_SUBSAMPLING, dmesh_period);
@@ -871,7 +1242,6 @@ namespace lsp
                 dm->vGraphs[DM_CORR].set_method(dspu::MM_SIGN_MAXIMUM);
 
                 dm->fPSRLevel            = 0.0f;
-                dm->nGonioStrobe        = nGonioPeriod;
             }
         }
 
@@ -965,9 +1335,19 @@ namespace lsp
         {
             const ssize_t first     = lsp_min(begin, limit);
             const ssize_t last      = lsp_min(end, limit);
+            const ssize_t start     = lsp_min(first, last);
+            const ssize_t stop      = lsp_max(first, last);
+
+            // Invalidate the prefetched data if loop range has changed
+            if ((al->nStart != start) || (al->nEnd != stop))
+            {
+                al->sPrefetch.bValid    = false;
+                al->sPrefetch.bSeam     = false;
+                al->bSeam               = false;
+            }
 
-            al->nStart              = lsp_min(first, last);
-            al->nEnd                = lsp_max(first, last);
+            al->nStart              = start;
+            al->nEnd                = stop;
             if (al->nStart < al->nEnd)
                 al->nPos                = lsp_limit(al->nPos, al->nStart, al->nEnd - 1);
             else
@@ -1051,7 +1431,7 @@ namespace lsp
             {
                 afile_t *af             = &vSamples[i];
                 af->fGain               = af->pGain->value();
-                ssize_t len             = (af->pSample != NULL) ? af->pSample->length() : 0;
+                ssize_t len             = af->nLength;
 
                 for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
                 {
@@ -1071,6 +1451,9 @@ namespace lsp
                             bSyncLoopMesh           = true;
                     }
                 }
+
+                // Rebuild the seams of the changed loops
+                update_loop_seams(af);
             }
         }
 
@@ -1084,8 +1467,9 @@ namespace lsp
             const float gm_react    = 10.0f / pGainMatchReact->value();
             nGainMatching           = pGainMatching->value();
             const float gm_ksr      = (M_LN10 / 20.0f) / fSampleRate;
-            fGainMatchGrow          = expf(gm_react * gm_ksr);
-            fGainMatchFall          = expf(-gm_react * gm_ksr);
+            fGainMatchRate          = gm_react * gm_ksr;
+            fGainMatchGrow          = expf(fGainMatchRate * meta::referencer::AUTOGAIN_STEP);
+            fGainMatchFall          = expf(-fGainMatchRate * meta::referencer::AUTOGAIN_STEP);
 
             // Waveform analysis
             sMix.fWaveformOff       = sMix.pFrameOffset->value();
@@ -1103,21 +1487,108 @@ namespace lsp
                 configure_filter(&c->sPostFilter, !pre_filter);
             }
 
+            // The precomputed timeline does not reflect the reference altered by pre-filters
+            bRefTimeline            =
+                (pRefTimeline->value() >= 0.5f) &&
+                ((!pre_filter) || (size_t(pFltSel->value()) == PF_OFF));
+
             // Update dynamics analysis
             fMaxTime                = pMaxTime->value();
-            const float llufs_time  = pLLUFSTime->value();
-            const size_t period     = dspu::seconds_to_samples(fSampleRate, fMaxTime / float(meta::referencer::DYNA_MESH_SIZE));
-            const size_t psr_period = dspu::seconds_to_samples(fSampleRate, pPsrPeriod->value());
             nPsrMode                = pPsrDisplay->value();
             const float psr_th      = dspu::gain_to_db(pPsrThreshold->value());
-            const bool reset_pk     = pResetPK->value() >= 0.5f;
-            const bool reset_tp     = pResetTP->value() >= 0.5f;
-            const bool reset_llufs  = pResetLLufs->value() >= 0.5f;
-            const bool reset_ilufs  = pResetILufs->value() >= 0.5f;
 
             nPsrThresh              = (psr_th * meta::referencer::PSR_MESH_SIZE) / (meta::referencer::PSR_MAX_LEVEL - meta::referencer::PSR_MIN_LEVEL);
             lsp_trace("psr_th = %f, nPsrThresh = %d", psr_th, int(nPsrThresh));
 
+            // Latch reset requests until they are applied to the analysis
+            if (pResetPK->value() >= 0.5f)
+                nAnalysisFlags         |= AU_RESET_PK;
+            if (pResetTP->value() >= 0.5f)
+                nAnalysisFlags         |= AU_RESET_TP;
+            if (pResetLLufs->value() >= 0.5f)
+                nAnalysisFlags         |= AU_RESET_LLUFS;
+            if (pResetILufs->value() >= 0.5f)
+                nAnalysisFlags         |= AU_RESET_ILUFS;
+            if (pFftReset->value() >= 0.5f)
+                nAnalysisFlags         |= AU_RESET_FFT;
+
+            // Compute the analysis required to display the current section
+            request_analysis_demand(ui_active());
+
+            // Update analysis, defer the update if the analysis task is currently running
+            nAnalysisMode           = pAnalysisMode->value();
+            nAnalysisFlags         |= AU_SETTINGS;
+            if (analysis_idle())
+                update_analysis();
+
+            // Apply configuration to channels
+            bool bypass             = pBypass->value() >= 0.5f;
+            size_t source           = pSource->value();
+            enMode                  = (pMode != NULL) ? decode_stereo_mode(pMode->value()) : SM_MONO;
+
+            bFreeze                 = pFreeze->value() >= 0.5f;
+
+            const bool profiling    = pProfiling->value() >= 0.5f;
+            if (profiling != bProfiling)
+            {
+                bProfiling              = profiling;
+                reset_profile();
+            }
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c            = &vChannels[i];
+
+                c->sBypass.set_bypass(bypass);
+            }
+
+            switch (source)
+            {
+                case SRC_MIX:
+                    sMix.fOldGain           = sMix.fGain;
+                    sMix.fNewGain           = GAIN_AMP_0_DB;
+                    sMix.nTransition        = 0;
+
+                    sRef.fOldGain           = sRef.fGain;
+                    sRef.fNewGain           = GAIN_AMP_M_INF_DB;
+                    sRef.nTransition        = 0;
+                    break;
+
+                case SRC_REFERENCE:
+                    sMix.fOldGain           = sMix.fGain;
+                    sMix.fNewGain           = GAIN_AMP_M_INF_DB;
+                    sMix.nTransition        = 0;
+
+                    sRef.fOldGain           = sRef.fGain;
+                    sRef.fNewGain           = GAIN_AMP_0_DB;
+                    sRef.nTransition        = 0;
+                    break;
+
+                case SRC_BOTH:
+                default:
+                    sMix.fOldGain           = sMix.fGain;
+                    sMix.fNewGain           = GAIN_AMP_M_6_DB;
+                    sMix.nTransition        = 0;
+
+                    sRef.fOldGain           = sRef.fGain;
+                    sRef.fNewGain           = GAIN_AMP_M_6_DB;
+                    sRef.nTransition        = 0;
+                    break;
+            }
+        }
+
+        void referencer::update_analysis_settings()
+        {
+            // Update dynamics analysis
+            const float llufs_time  = pLLUFSTime->value();
+            const size_t period     = dspu::seconds_to_samples(fSampleRate, fMaxTime / float(meta::referencer::DYNA_MESH_SIZE));
+            const size_t psr_period = dspu::seconds_to_samples(fSampleRate, pPsrPeriod->value());
+            const bool reset_pk     = nAnalysisFlags & AU_RESET_PK;
+            const bool reset_tp     = nAnalysisFlags & AU_RESET_TP;
+            const bool reset_llufs  = nAnalysisFlags & AU_RESET_LLUFS;
+            const bool reset_ilufs  = nAnalysisFlags & AU_RESET_ILUFS;
+            const bool reset_psr    = nAnalysisFlags & AU_RESET_PSR;
+
             for (size_t i=0; i<2; ++i)
             {
                 dyna_meters_t *dm       = &vDynaMeters[i];
@@ -1134,6 +1605,8 @@ namespace lsp
                     dm->sLLUFSMeter.clear();
                 if (reset_ilufs)
                     dm->sILUFSMeter.clear();
+                if (reset_psr)
+                    dm->sPSRStats.clear();
             }
 
             // Apply FFT analysis settings
@@ -1143,9 +1616,22 @@ namespace lsp
             const size_t fft_window = pFftWindow->value();
             const size_t fft_env    = pFftEnvelope->value();
             const size_t fft_size   = 1 << fft_rank;
+            const uint32_t fft_prd  = fft_period(pFftRefresh->value(), fft_size);
+            const float fft_rate    = fSampleRate / float(fft_prd);
+
+            // Smoothing coefficients are applied once per FFT frame, compute them for the actual frame rate
+            fFftTau                 = expf(logf(1.0f - M_SQRT1_2) / dspu::seconds_to_samples(fft_rate, fft_react));
+            fFftBal                 = expf(logf(1.0f - M_SQRT1_2) / dspu::seconds_to_samples(fft_rate, fft_ball));
+            nFftRefresh             = pFftRefresh->value();
+            for (size_t i=0; i<2; ++i)
+            {
+                fft_meters_t *fm        = &vFftMeters[i];
+                if (fm->nFftPeriod == fft_prd)
+                    continue;
 
-            fFftTau                 = expf(logf(1.0f - M_SQRT1_2) / dspu::seconds_to_samples(meta::referencer::SPC_REFRESH_RATE, fft_react));
-            fFftBal                 = expf(logf(1.0f - M_SQRT1_2) / dspu::seconds_to_samples(meta::referencer::SPC_REFRESH_RATE, fft_ball));
+                fm->nFftPeriod          = fft_prd;
+                fm->nFftFrame           = fft_frame_phase(fft_prd, i);
+            }
             bFftDamping             = pFftDamping->value() >= 0.5f;
             nFftSrc                 = pFftVMarkSrc->value();
             fFftFreq                = pFftVMarkFreq->value();
@@ -1158,7 +1644,7 @@ namespace lsp
             }
 
             // Need to reset values?
-            if (pFftReset->value() >= 0.5f)
+            if (nAnalysisFlags & AU_RESET_FFT)
                 reset_fft();
 
             const float fft_csize   = fft_size >> 1;
@@ -1202,69 +1688,261 @@ namespace lsp
                 reduce_spectrum(vFftEnvelope, vBuffer);
                 dsp::mul_k2(vFftEnvelope, GAIN_AMP_P_12_DB / fft_size, meta::referencer::SPC_MESH_SIZE);
             }
+        }
 
-            // Apply configuration to channels
-            bool bypass             = pBypass->value() >= 0.5f;
-            size_t source           = pSource->value();
-            enMode                  = (pMode != NULL) ? decode_stereo_mode(pMode->value()) : SM_MONO;
-
-            bFreeze                 = pFreeze->value() >= 0.5f;
-
-            for (size_t i=0; i<nChannels; ++i)
+        void referencer::update_analysis()
+        {
+            // The captured data does not match the new sample rate, drop it
+            if (nAnalysisFlags & AU_SAMPLE_RATE)
             {
-                channel_t *c            = &vChannels[i];
-
-                c->sBypass.set_bypass(bypass);
+                update_analysis_sample_rate();
+                nCaptureTail            = nCaptureHead;
+                nCaptureFill            = 0;
             }
 
-            switch (source)
-            {
-                case SRC_MIX:
-                    sMix.fOldGain           = sMix.fGain;
-                    sMix.fNewGain           = GAIN_AMP_0_DB;
-                    sMix.nTransition        = 0;
+            if (nAnalysisFlags & AU_SETTINGS)
+                update_analysis_settings();
+            if (nAnalysisFlags & AU_DEMAND)
+                update_analysis_demand();
 
-                    sRef.fOldGain           = sRef.fGain;
-                    sRef.fNewGain           = GAIN_AMP_M_INF_DB;
-                    sRef.nTransition        = 0;
+            nAnalysisFlags          = 0;
+        }
+
+        uint32_t referencer::decode_analysis_demand(size_t section)
+        {
+            switch (section)
+            {
+                case meta::referencer::TAB_SAMPLES:     return AD_NONE;
+                case meta::referencer::TAB_LOUDNESS:    return AD_LOUDNESS;
+                case meta::referencer::TAB_WAVEFORM:    return AD_WAVEFORM;
+                case meta::referencer::TAB_SPECTRUM:    return AD_SPECTRUM;
+                case meta::referencer::TAB_DYNAMICS:    return AD_LOUDNESS;
+                case meta::referencer::TAB_CORRELATION: return AD_STEREO | AD_SPECTRUM;
+                case meta::referencer::TAB_STEREO:      return AD_STEREO | AD_SPECTRUM | AD_GONIOMETER;
+                case meta::referencer::TAB_OVERVIEW:
+                default:
                     break;
+            }
 
-                case SRC_REFERENCE:
-                    sMix.fOldGain           = sMix.fGain;
-                    sMix.fNewGain           = GAIN_AMP_M_INF_DB;
-                    sMix.nTransition        = 0;
+            return AD_ALL;
+        }
 
-                    sRef.fOldGain           = sRef.fGain;
-                    sRef.fNewGain           = GAIN_AMP_0_DB;
-                    sRef.nTransition        = 0;
-                    break;
+        void referencer::request_analysis_demand(bool ui)
+        {
+            // Without UI there is nothing to display. Meter values are visible to the host and
+            // are computed regardless of the current tab, the tab selects only the data for meshes
+            const uint32_t demand       = (ui) ? decode_analysis_demand(pSection->value()) : uint32_t(AD_NONE);
+            const uint32_t mix_demand   = (((ui) && (pMixVisible->value() >= 0.5f)) ? demand : uint32_t(AD_NONE)) | AD_METERS;
+            const uint32_t ref_demand   = (((ui) && (pRefVisible->value() >= 0.5f)) ? demand : uint32_t(AD_NONE)) | AD_METERS;
+            nMeshDemand                 = demand;
+            if ((vDynaMeters[0].nNewDemand == mix_demand) && (vDynaMeters[1].nNewDemand == ref_demand))
+                return;
 
-                case SRC_BOTH:
-                default:
-                    sMix.fOldGain           = sMix.fGain;
-                    sMix.fNewGain           = GAIN_AMP_M_6_DB;
-                    sMix.nTransition        = 0;
+            vDynaMeters[0].nNewDemand   = mix_demand;
+            vDynaMeters[1].nNewDemand   = ref_demand;
+            nAnalysisFlags             |= AU_DEMAND;
+        }
 
-                    sRef.fOldGain           = sRef.fGain;
-                    sRef.fNewGain           = GAIN_AMP_M_6_DB;
-                    sRef.nTransition        = 0;
-                    break;
+        void referencer::update_analysis_demand()
+        {
+            for (size_t i=0; i<2; ++i)
+            {
+                dyna_meters_t *dm       = &vDynaMeters[i];
+                fft_meters_t *fm        = &vFftMeters[i];
+
+                // The analysis which was skipped holds outdated data, reset it before enabling
+                const uint32_t enabled  = dm->nNewDemand & (~dm->nDemand);
+                dm->nDemand             = dm->nNewDemand;
+
+                if (enabled & AD_WAVEFORM)
+                {
+                    for (size_t j=0; j<WF_TOTAL; ++j)
+                    {
+                        dm->vWaveform[j].clear();
+                        clear_wf_peaks(&dm->vWfPeaks[j]);
+                    }
+                }
+
+                if (enabled & AD_LOUDNESS)
+                {
+                    dm->sPSRDelay.clear();
+                    dm->sMLUFSMeter.clear();
+                    dm->sSLUFSMeter.clear();
+                    dm->sPSRStats.clear();
+                    dm->fPSRLevel           = 0.0;
+                    dm->vGraphs[DM_RMS].clear();
+                    dm->vGraphs[DM_M_LUFS].clear();
+                    dm->vGraphs[DM_S_LUFS].clear();
+                    dm->vGraphs[DM_PSR].clear();
+                }
+
+                if (enabled & AD_STEREO)
+                {
+                    dm->sCorrMeter.clear();
+                    dm->sPanometer.clear();
+                    dm->sMsBalance.clear();
+                    dm->vGraphs[DM_CORR].clear();
+                    dm->vGraphs[DM_PAN].clear();
+                    dm->vGraphs[DM_MSBAL].clear();
+                }
+
+                if (enabled & AD_SPECTRUM)
+                {
+                    dsp::fill_zero(fm->vHistory[0], meta::referencer::SPC_HISTORY_SIZE);
+                    if (nChannels > 1)
+                        dsp::fill_zero(fm->vHistory[1], meta::referencer::SPC_HISTORY_SIZE);
+                    fm->nFftFrame           = fft_frame_phase(fm->nFftPeriod, i);
+                    fm->nFftHistory         = 0;
+                }
             }
         }
 
         void referencer::destroy_sample(dspu::Sample * &sample)
         {
+            if (sample == NULL)
+                return;
+
+            // The shared sample is destroyed by the last instance which refers to it,
+            // there is no need to lock the shared samples if nothing is shared
+            if ((atomic_load(&nSharedSamples) <= 0) || (!release_shared(sample)))
+                delete sample;
+            sample                  = NULL;
+        }
+
+        bool referencer::acquire_shared(afile_t *af, const LSPString *key)
+        {
+            sSharedLock.lock();
+            lsp_finally { sSharedLock.unlock(); };
+
+            for (size_t i=0, n=vShared.size(); i<n; ++i)
+            {
+                shared_sample_t *ss     = vShared.uget(i);
+                if ((ss->nDataRefs <= 0) || (ss->nPeakRefs <= 0) || (!ss->sKey.equals(key)))
+                    continue;
+
+                ++ss->nDataRefs;
+                ++ss->nPeakRefs;
+                af->pLoaded             = ss->pSample;
+                af->pLoadedCompact      = ss->pCompact;
+                af->pLoadedPeaks        = ss->pPeaks;
+                af->sLoadedStats        = ss->sStats;
+
+                return true;
+            }
+
+            return false;
+        }
+
+        void referencer::publish_shared(const LSPString *key, dspu::Sample *sample, csample_t *compact, peaks_t *peaks, const file_stats_t *stats)
+        {
+            if (((sample == NULL) && (compact == NULL)) || (peaks == NULL))
+                return;
+
+            sSharedLock.lock();
+            lsp_finally { sSharedLock.unlock(); };
+
+            // Another instance could load the same file at the same time, keep the private copy then
+            for (size_t i=0, n=vShared.size(); i<n; ++i)
+            {
+                shared_sample_t *ss     = vShared.uget(i);
+                if ((ss->nDataRefs > 0) && (ss->sKey.equals(key)))
+                    return;
+            }
+
+            shared_sample_t *ss     = new shared_sample_t;
+            if (ss == NULL)
+                return;
+            if ((!ss->sKey.set(key)) || (!vShared.add(ss)))
+            {
+                delete ss;
+                return;
+            }
+
+            ss->pSample             = sample;
+            ss->pCompact            = compact;
+            ss->pPeaks              = peaks;
+            ss->sStats              = *stats;
+            ss->nDataRefs           = 1;
+            ss->nPeakRefs           = 1;
+
+            // Mark the data as shared to make the destruction of private data lock-free
+            peaks->bShared          = true;
+            if (compact != NULL)
+                compact->bShared        = true;
             if (sample != NULL)
+                atomic_store(&nSharedSamples, nSharedSamples + 1);
+        }
+
+        bool referencer::release_shared(const void *data)
+        {
+            sSharedLock.lock();
+            lsp_finally { sSharedLock.unlock(); };
+
+            for (size_t i=0, n=vShared.size(); i<n; ++i)
             {
-                delete sample;
-                sample                  = NULL;
+                shared_sample_t *ss     = vShared.uget(i);
+                bool last               = false;
+
+                if ((ss->pSample == data) || (ss->pCompact == data))
+                {
+                    last                    = (--ss->nDataRefs) <= 0;
+                    if (last)
+                    {
+                        if (ss->pSample != NULL)
+                            atomic_store(&nSharedSamples, nSharedSamples - 1);
+                        ss->pSample             = NULL;
+                        ss->pCompact            = NULL;
+                    }
+                }
+                else if (ss->pPeaks == data)
+                {
+                    last                    = (--ss->nPeakRefs) <= 0;
+                    if (last)
+                        ss->pPeaks              = NULL;
+                }
+                else
+                    continue;
+
+                // Forget the record when nobody refers to it
+                if ((ss->nDataRefs <= 0) && (ss->nPeakRefs <= 0))
+                    remove_shared(i);
+
+                // The caller destroys the data when the last reference is released
+                return !last;
             }
+
+            return false;
+        }
+
+        void referencer::remove_shared(size_t index)
+        {
+            shared_sample_t *ss     = vShared.uget(index);
+            vShared.qremove(index);
+            delete ss;
+        }
+
+        void referencer::destroy_stream(dsample_t * &stream)
+        {
+            if (stream == NULL)
+                return;
+
+            // Close and remove the file
+            stream->sFile.close();
+            if ((stream->bTemporary) && (!stream->sPath.is_empty()))
+                io::File::remove(&stream->sPath);
+
+            free_aligned(stream->pData);
+            delete stream;
+            stream                  = NULL;
         }
 
         void referencer::unload_afile(afile_t *af)
         {
             // Destroy original sample if present
             destroy_sample(af->pLoaded);
+            destroy_stream(af->pLoadedStream);
+            destroy_compact(af->pLoadedCompact);
+            destroy_peaks(af->pLoadedPeaks);
 
             // Destroy pointer to thumbnails
             if (af->vThumbs[0])
@@ -1290,116 +1968,1541 @@ namespace lsp
             }
         }
 
-        void referencer::copy_waveform(float *dst, dspu::RawRingBuffer *rb, size_t offset, size_t length, size_t dst_len)
+        referencer::peaks_t *referencer::create_peaks(size_t channels, size_t length)
         {
-            const float *src    = rb->begin();
-            const size_t limit  = rb->size();
+            peaks_t *peaks          = new peaks_t;
+            if (peaks == NULL)
+                return NULL;
+
+            // Compute the layout of the pyramid, each next level is twice smaller than the previous one
+            size_t size             = 0;
+            size_t count            = lsp_max((length + meta::referencer::PEAK_BLOCK_SIZE - 1) / meta::referencer::PEAK_BLOCK_SIZE, size_t(1));
+            size_t levels           = 0;
+            while (levels < meta::referencer::PEAK_LEVELS_MAX)
+            {
+                peaks->vOffset[levels++]= size;
+                size                   += count;
+                if (count <= 1)
+                    break;
+                count                   = (count + 1) >> 1;
+            }
 
-            // Compute the initial offset to start from
-            offset              = (rb->position() + limit - length - offset) % limit;
+            peaks->nLength          = length;
+            peaks->nLevels          = levels;
+            peaks->nSize            = size;
+            peaks->pTimeline        = NULL;
+            peaks->bShared          = false;
+            peaks->pData            = NULL;
 
-            if (length > dst_len)
+            const size_t szof_peaks = align_size(sizeof(float) * size, OPTIMAL_ALIGN);
+            uint8_t *ptr            = alloc_aligned<uint8_t>(peaks->pData, szof_peaks * channels, OPTIMAL_ALIGN);
+            if (ptr == NULL)
             {
-                for (size_t i=0; i<dst_len; ++i)
-                {
-                    size_t first    = (i * length) / dst_len;
-                    size_t last     = ((i + 1) * length) / dst_len;
-                    if (first < last)
-                    {
-                        first           = (first + offset) % limit;
-                        last            = (last + offset) % limit;
+                destroy_peaks(peaks);
+                return NULL;
+            }
 
-                        if (first > last)
-                        {
-                            const float a   = dsp::sign_max(&src[first], limit - first);
-                            const float b   = dsp::sign_max(&src[0], last);
-                            dst[i]          = (fabsf(a) >= fabsf(b)) ? a : b;
-                        }
-                        else
-                            dst[i]          = dsp::sign_max(&src[first], last - first);
-                    }
-                    else if (first < length)
-                        dst[i]          = src[(first + offset) % limit];
-                    else
-                        dst[i]          = 0.0f;
-                }
+            for (size_t i=0; i<meta::referencer::CHANNELS_MAX; ++i)
+                peaks->vData[i]         = (i < channels) ? advance_ptr_bytes<float>(ptr, szof_peaks) : NULL;
+
+            return peaks;
+        }
+
+        void referencer::destroy_peaks(peaks_t * &peaks)
+        {
+            if (peaks == NULL)
+                return;
+            if ((peaks->bShared) && (release_shared(peaks)))
+            {
+                peaks                   = NULL;
+                return;
             }
-            else
+
+            destroy_timeline(peaks->pTimeline);
+            free_aligned(peaks->pData);
+            delete peaks;
+            peaks                   = NULL;
+        }
+
+        referencer::atimeline_t *referencer::create_timeline(size_t channels, size_t frames)
+        {
+            atimeline_t *tl         = new atimeline_t;
+            if (tl == NULL)
+                return NULL;
+
+            tl->nChannels           = channels;
+            tl->nFrames             = frames;
+            tl->pData               = NULL;
+
+            const size_t szof_frames= align_size(sizeof(float) * lsp_max(frames, size_t(1)), OPTIMAL_ALIGN);
+            uint8_t *ptr            = alloc_aligned<uint8_t>(tl->pData, szof_frames * TL_TOTAL, OPTIMAL_ALIGN);
+            if (ptr == NULL)
             {
-                for (size_t i=0; i<dst_len; ++i)
+                destroy_timeline(tl);
+                return NULL;
+            }
+
+            for (size_t i=0; i<TL_TOTAL; ++i)
+                tl->vData[i]            = advance_ptr_bytes<float>(ptr, szof_frames);
+
+            return tl;
+        }
+
+        void referencer::destroy_timeline(atimeline_t * &timeline)
+        {
+            if (timeline == NULL)
+                return;
+
+            free_aligned(timeline->pData);
+            delete timeline;
+            timeline                = NULL;
+        }
+
+        void referencer::expand_timeline(float *dst, const float *src, size_t pos, size_t count)
+        {
+            while (count > 0)
+            {
+                const size_t frame      = pos / TIMELINE_STEP;
+                const size_t to_do      = lsp_min(count, (frame + 1) * TIMELINE_STEP - pos);
+                dsp::fill(dst, src[frame], to_do);
+
+                dst                    += to_do;
+                pos                    += to_do;
+                count                  -= to_do;
+            }
+        }
+
+        status_t referencer::build_timeline(peaks_t *peaks, const dspu::Sample *sample)
+        {
+            const size_t s_channels = sample->channels();
+            const size_t length     = sample->length();
+            const size_t frames     = (length + TIMELINE_STEP - 1) / TIMELINE_STEP;
+
+            atimeline_t *tl         = create_timeline(nChannels, frames);
+            if (tl == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_timeline(tl); };
+
+            uint8_t *data           = NULL;
+            float *buf              = alloc_aligned<float>(data, TIMELINE_STEP, OPTIMAL_ALIGN);
+            if (buf == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free_aligned(data); };
+
+            // Initialize meters the same way as the reference meters are initialized,
+            // each channel of the plugin refers to it's own channel of the sample
+            dspu::TruePeakMeter tp_meter[2];
+            dspu::LoudnessMeter m_meter;
+            dspu::LoudnessMeter s_meter;
+            lsp_finally {
+                tp_meter[0].destroy();
+                tp_meter[1].destroy();
+                m_meter.destroy();
+                s_meter.destroy();
+            };
+
+            // There are no shared K-weighting filters, so the loudness meters apply K-weighting by themselves
+            status_t res            = init_loudness_meter(&m_meter, nChannels, dspu::bs::LUFS_MOMENTARY_PERIOD,
+                dspu::bs::LUFS_MOMENTARY_PERIOD, dspu::bs::WEIGHT_K);
+            if (res != STATUS_OK)
+                return res;
+            res                     = init_loudness_meter(&s_meter, nChannels, dspu::bs::LUFS_SHORT_TERM_PERIOD,
+                dspu::bs::LUFS_SHORT_TERM_PERIOD, dspu::bs::WEIGHT_K);
+            if (res != STATUS_OK)
+                return res;
+
+            m_meter.set_sample_rate(fSampleRate);
+            s_meter.set_sample_rate(fSampleRate);
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                if (!tp_meter[i].init())
+                    return STATUS_NO_MEM;
+                tp_meter[i].set_sample_rate(fSampleRate);
+            }
+
+            // Store maximum true peak of each frame and loudness at the end of each frame
+            for (size_t i=0, offset=0; i<frames; ++i)
+            {
+                const size_t count      = lsp_min(length - offset, TIMELINE_STEP);
+                float true_peak         = 0.0f;
+                for (size_t j=0; j<nChannels; ++j)
                 {
-                    size_t first    = (i * length) / dst_len;
-                    dst[i]          = src[(first + offset) % limit];
+                    const float *src        = sample->channel(j % s_channels, offset);
+                    tp_meter[j].process(buf, src, count);
+                    true_peak               = lsp_max(true_peak, dsp::max(buf, count));
+                    m_meter.bind(j, NULL, src, 0);
+                    s_meter.bind(j, NULL, src, 0);
                 }
+                tl->vData[TL_TRUE_PEAK][i]  = true_peak;
+
+                m_meter.process(buf, count, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                tl->vData[TL_M_LUFS][i]     = buf[count - 1];
+                s_meter.process(buf, count, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                tl->vData[TL_S_LUFS][i]     = buf[count - 1];
+
+                offset                 += count;
+            }
+
+            // Commit the result
+            lsp::swap(peaks->pTimeline, tl);
+
+            return STATUS_OK;
+        }
+
+        referencer::csample_t *referencer::create_compact(size_t channels, size_t length)
+        {
+            csample_t *cs           = new csample_t;
+            if (cs == NULL)
+                return NULL;
+
+            cs->nChannels           = channels;
+            cs->nLength             = length;
+            cs->nBlocks             = (length + COMPACT_BLOCK_SIZE - 1) / COMPACT_BLOCK_SIZE;
+            cs->bShared             = false;
+            cs->pData               = NULL;
+
+            const size_t szof_data  = align_size(sizeof(int16_t) * length, OPTIMAL_ALIGN);
+            const size_t szof_scale = align_size(sizeof(float) * cs->nBlocks, OPTIMAL_ALIGN);
+            uint8_t *ptr            = alloc_aligned<uint8_t>(cs->pData, (szof_data + szof_scale) * channels, OPTIMAL_ALIGN);
+            if (ptr == NULL)
+            {
+                destroy_compact(cs);
+                return NULL;
+            }
+
+            for (size_t i=0; i<meta::referencer::CHANNELS_MAX; ++i)
+            {
+                cs->vData[i]            = (i < channels) ? advance_ptr_bytes<int16_t>(ptr, szof_data) : NULL;
+                cs->vScale[i]           = (i < channels) ? advance_ptr_bytes<float>(ptr, szof_scale) : NULL;
+            }
+
+            return cs;
+        }
+
+        void referencer::destroy_compact(csample_t * &compact)
+        {
+            if (compact == NULL)
+                return;
+            if ((compact->bShared) && (release_shared(compact)))
+            {
+                compact                 = NULL;
+                return;
+            }
+
+            free_aligned(compact->pData);
+            delete compact;
+            compact                 = NULL;
+        }
+
+        void referencer::encode_compact(csample_t *cs, size_t channel, const float *src)
+        {
+            int16_t *dst            = cs->vData[channel];
+            float *scale            = cs->vScale[channel];
+
+            // Each block is normalized to its own peak to keep the precision of quiet parts
+            for (size_t offset=0, block=0; offset < cs->nLength; offset += COMPACT_BLOCK_SIZE, ++block)
+            {
+                const size_t count      = lsp_min(cs->nLength - offset, COMPACT_BLOCK_SIZE);
+                const float peak        = dsp::abs_max(&src[offset], count);
+                const float k           = (peak > 0.0f) ? 32767.0f / peak : 0.0f;
+
+                scale[block]            = peak / 32767.0f;
+                for (size_t i=0; i<count; ++i)
+                    dst[offset + i]         = int16_t(lrintf(src[offset + i] * k));
+            }
+        }
+
+        void referencer::decode_compact(float *dst, const csample_t *cs, size_t channel, size_t offset, size_t count, float gain)
+        {
+            const int16_t *src      = &cs->vData[channel][offset];
+            const float *scale      = cs->vScale[channel];
+
+            for (size_t i=0; i<count; )
+            {
+                const size_t pos        = offset + i;
+                const size_t to_do      = lsp_min(count - i, COMPACT_BLOCK_SIZE - pos % COMPACT_BLOCK_SIZE);
+                const float k           = scale[pos / COMPACT_BLOCK_SIZE] * gain;
+
+                for (size_t j=0; j<to_do; ++j)
+                    dst[i + j]              = float(src[i + j]) * k;
+                i                      += to_do;
+            }
+        }
+
+        void referencer::build_peaks(peaks_t *peaks, size_t channel, const float *src)
+        {
+            float *dst              = peaks->vData[channel];
+
+            // Build the first level from the sample data
+            const size_t length     = peaks->nLength;
+            for (size_t i=0, offset=0; offset < length; ++i, offset += meta::referencer::PEAK_BLOCK_SIZE)
+                dst[i]                  = dsp::abs_max(&src[offset], lsp_min(length - offset, meta::referencer::PEAK_BLOCK_SIZE));
+            if (length == 0)
+                dst[0]                  = 0.0f;
+
+            // Build each next level from the previous one
+            for (size_t i=1; i<peaks->nLevels; ++i)
+            {
+                const float *prev       = &dst[peaks->vOffset[i-1]];
+                float *curr             = &dst[peaks->vOffset[i]];
+                const size_t count      = peaks->vOffset[i] - peaks->vOffset[i-1];
+
+                for (size_t j=0; j<count; j += 2)
+                    *(curr++)               = (j + 1 < count) ? lsp_max(prev[j], prev[j+1]) : prev[j];
+            }
+        }
+
+        float referencer::get_peak(const peaks_t *peaks, size_t channel, size_t first, size_t last)
+        {
+            // Find the level where the block size does not exceed the requested range
+            const size_t len        = last - first;
+            size_t level            = 0;
+            while ((level + 1 < peaks->nLevels) && ((meta::referencer::PEAK_BLOCK_SIZE << (level + 1)) <= len))
+                ++level;
+
+            // Compute the maximum of all blocks that cover the range
+            const size_t block      = meta::referencer::PEAK_BLOCK_SIZE << level;
+            const size_t i_first    = first / block;
+            const size_t i_last     = (last + block - 1) / block;
+            const float *src        = &peaks->vData[channel][peaks->vOffset[level]];
+
+            return (i_first < i_last) ? dsp::max(&src[i_first], i_last - i_first) : src[i_first];
+        }
+
+        void referencer::make_peak_thumbnail(float *dst, const peaks_t *peaks, size_t channel, size_t offset, size_t len, size_t dst_len)
+        {
+            for (size_t i=0; i<dst_len; ++i)
+            {
+                size_t first    = (i * len) / dst_len;
+                size_t last     = ((i + 1) * len) / dst_len;
+                if (first < last)
+                    dst[i]          = get_peak(peaks, channel, offset + first, offset + last);
+                else if (first < len)
+                    dst[i]          = get_peak(peaks, channel, offset + first, offset + first + 1);
+                else
+                    dst[i]          = 0.0f;
             }
         }
 
-        status_t referencer::load_file(afile_t *af)
+        void referencer::render_thumbnail(float *dst, const peaks_t *peaks, const dspu::Sample *sample, size_t channel, size_t offset, size_t len, size_t dst_len)
+        {
+            // Use the precise sample data for short ranges and peak pyramid otherwise
+            if ((sample != NULL) && (len < dst_len * meta::referencer::PEAK_BLOCK_SIZE))
+                make_thumbnail(dst, sample->channel(channel, offset), len, dst_len);
+            else
+                make_peak_thumbnail(dst, peaks, channel, offset, len, dst_len);
+        }
+
+        status_t referencer::make_file_thumbnails(afile_t *af, const peaks_t *peaks, const dspu::Sample *sample)
+        {
+            float *thumbs           = static_cast<float *>(malloc(sizeof(float) * meta::referencer::CHANNELS_MAX * meta::referencer::FILE_MESH_SIZE));
+            if (thumbs == NULL)
+                return STATUS_NO_MEM;
+
+            for (size_t i=0; i<meta::referencer::CHANNELS_MAX; ++i)
+            {
+                if (peaks->vData[i] == NULL)
+                    break;
+
+                af->vThumbs[i]          = thumbs;
+                thumbs                 += meta::referencer::FILE_MESH_SIZE;
+                render_thumbnail(af->vThumbs[i], peaks, sample, i, 0, peaks->nLength, meta::referencer::FILE_MESH_SIZE);
+            }
+
+            return STATUS_OK;
+        }
+
+        bool referencer::init_wf_peaks(wf_peaks_t *wp, size_t size)
+        {
+            destroy_wf_peaks(wp);
+
+            // Each level should keep enough peaks to cover the whole ring buffer
+            size_t levels       = 0;
+            size_t total        = 0;
+            for (size_t block = meta::referencer::WAVE_PEAK_BLOCK_SIZE;
+                (block <= size) && (levels < meta::referencer::WAVE_PEAK_LEVELS_MAX);
+                block <<= 1)
+            {
+                wp->vSize[levels]   = size / block + 2;
+                total              += align_size(wp->vSize[levels], 16);
+                ++levels;
+            }
+
+            uint8_t *ptr        = NULL;
+            if (levels > 0)
+            {
+                ptr                 = alloc_aligned<uint8_t>(wp->pData, total * sizeof(float), OPTIMAL_ALIGN);
+                if (ptr == NULL)
+                    return false;
+                dsp::fill_zero(reinterpret_cast<float *>(ptr), total);
+            }
+
+            for (size_t i=0; i<levels; ++i)
+            {
+                wp->vData[i]        = advance_ptr_bytes<float>(ptr, align_size(wp->vSize[i], 16) * sizeof(float));
+                wp->vAcc[i]         = 0.0f;
+            }
+
+            wp->nCount          = 0;
+            wp->nLevels         = levels;
+
+            return true;
+        }
+
+        void referencer::clear_timeline_meters(dyna_meters_t *dm)
+        {
+            dm->sTPMeter[0].clear();
+            dm->sTPMeter[1].clear();
+            dm->sMLUFSMeter.clear();
+            dm->sSLUFSMeter.clear();
+            dm->sPSRDelay.clear();
+        }
+
+        void referencer::clear_wf_peaks(wf_peaks_t *wp)
+        {
+            for (size_t i=0; i<wp->nLevels; ++i)
+            {
+                dsp::fill_zero(wp->vData[i], wp->vSize[i]);
+                wp->vAcc[i]         = 0.0f;
+            }
+            wp->nCount          = 0;
+        }
+
+        void referencer::destroy_wf_peaks(wf_peaks_t *wp)
+        {
+            free_aligned(wp->pData);
+            wp->nLevels         = 0;
+        }
+
+        void referencer::push_wf_peaks(wf_peaks_t *wp, const float *src, size_t count)
+        {
+            if (wp->nLevels <= 0)
+                return;
+
+            while (count > 0)
+            {
+                // Update the signed peak of the current block
+                const size_t offset = wp->nCount % meta::referencer::WAVE_PEAK_BLOCK_SIZE;
+                const size_t to_do  = lsp_min(meta::referencer::WAVE_PEAK_BLOCK_SIZE - offset, count);
+                const float peak    = dsp::sign_max(src, to_do);
+                wp->vAcc[0]         = ((offset == 0) || (fabsf(peak) > fabsf(wp->vAcc[0]))) ? peak : wp->vAcc[0];
+
+                src                += to_do;
+                count              -= to_do;
+                wp->nCount         += to_do;
+                if (offset + to_do < meta::referencer::WAVE_PEAK_BLOCK_SIZE)
+                    break;
+
+                // The block is complete, propagate it's peak to the upper levels
+                wsize_t index       = wp->nCount / meta::referencer::WAVE_PEAK_BLOCK_SIZE - 1;
+                float value         = wp->vAcc[0];
+                for (size_t i=0; i<wp->nLevels; ++i)
+                {
+                    wp->vData[i][index % wp->vSize[i]] = value;
+                    if (i + 1 >= wp->nLevels)
+                        break;
+
+                    float *acc          = &wp->vAcc[i + 1];
+                    if (!(index & 1))
+                    {
+                        // The first half of the upper level block
+                        *acc                = value;
+                        break;
+                    }
+
+                    // The second half of the upper level block, the block is complete
+                    *acc                = (fabsf(value) > fabsf(*acc)) ? value : *acc;
+                    value               = *acc;
+                    index             >>= 1;
+                }
+            }
+        }
+
+        float referencer::get_wf_peak(const wf_peaks_t *wp, wssize_t first, wssize_t last)
+        {
+            first               = lsp_max(first, wssize_t(0));
+            if (last <= first)
+                return 0.0f;
+
+            // Find the level where the block size does not exceed the requested range
+            const wssize_t len  = last - first;
+            size_t level        = 0;
+            while ((level + 1 < wp->nLevels) && (wssize_t(meta::referencer::WAVE_PEAK_BLOCK_SIZE << (level + 1)) <= len))
+                ++level;
+
+            const wssize_t block= meta::referencer::WAVE_PEAK_BLOCK_SIZE << level;
+            const wssize_t count= wp->nCount;
+            float result        = 0.0f;
+
+            for (wssize_t k = first / block; k * block < last; ++k)
+            {
+                float value;
+                if ((k + 1) * block <= count)
+                    value               = wp->vData[level][k % wp->vSize[level]];
+                else
+                {
+                    // The block is not complete, collect the peak from the incomplete blocks of lower levels
+                    value               = 0.0f;
+                    for (ssize_t i=level; i>=0; --i)
+                    {
+                        const wssize_t lblock   = meta::referencer::WAVE_PEAK_BLOCK_SIZE << i;
+                        const bool started      = (i > 0) ? ((count / (lblock >> 1)) & 1) : (count % lblock) != 0;
+                        if ((started) && (fabsf(wp->vAcc[i]) > fabsf(value)))
+                            value                   = wp->vAcc[i];
+                    }
+                }
+
+                if (fabsf(value) > fabsf(result))
+                    result              = value;
+            }
+
+            return result;
+        }
+
+        void referencer::copy_waveform(float *dst, dspu::RawRingBuffer *rb, const wf_peaks_t *wp, size_t offset, size_t length, size_t dst_len)
+        {
+            // Use the peak tree if there are too many samples per each point
+            if ((wp->nLevels > 0) && (length >= dst_len * meta::referencer::WAVE_PEAK_BLOCK_SIZE))
+            {
+                const wssize_t end      = wssize_t(wp->nCount) - offset;
+                const wssize_t start    = end - length;
+
+                for (size_t i=0; i<dst_len; ++i)
+                {
+                    const wssize_t first    = start + (i * length) / dst_len;
+                    const wssize_t last     = start + ((i + 1) * length) / dst_len;
+                    dst[i]                  = get_wf_peak(wp, first, last);
+                }
+                return;
+            }
+
+            const float *src    = rb->begin();
+            const size_t limit  = rb->size();
+
+            // Compute the initial offset to start from
+            offset              = (rb->position() + limit - length - offset) % limit;
+
+            if (length > dst_len)
+            {
+                for (size_t i=0; i<dst_len; ++i)
+                {
+                    size_t first    = (i * length) / dst_len;
+                    size_t last     = ((i + 1) * length) / dst_len;
+                    if (first < last)
+                    {
+                        first           = (first + offset) % limit;
+                        last            = (last + offset) % limit;
+
+                        if (first > last)
+                        {
+                            const float a   = dsp::sign_max(&src[first], limit - first);
+                            const float b   = dsp::sign_max(&src[0], last);
+                            dst[i]          = (fabsf(a) >= fabsf(b)) ? a : b;
+                        }
+                        else
+                            dst[i]          = dsp::sign_max(&src[first], last - first);
+                    }
+                    else if (first < length)
+                        dst[i]          = src[(first + offset) % limit];
+                    else
+                        dst[i]          = 0.0f;
+                }
+            }
+            else
+            {
+                for (size_t i=0; i<dst_len; ++i)
+                {
+                    size_t first    = (i * length) / dst_len;
+                    dst[i]          = src[(first + offset) % limit];
+                }
+            }
+        }
+
+        status_t referencer::load_file(afile_t *af)
+        {
+            // Load sample
+            lsp_trace("file = %p", af);
+
+            // Validate arguments
+            if ((af == NULL) || (af->pFile == NULL))
+                return STATUS_UNKNOWN_ERR;
+
+            unload_afile(af);
+            af->nLoadedOrigin       = SO_NONE;
+            clear_stats(&af->sLoadedStats);
+
+            // Get path
+            plug::path_t *path      = af->pFile->buffer<plug::path_t>();
+            if (path == NULL)
+                return STATUS_UNKNOWN_ERR;
+
+            // Get file name
+            const char *fname   = path->path();
+            if (strlen(fname) <= 0)
+                return STATUS_UNSPECIFIED;
+
+            // Try to use the sample data already loaded by another instance of the plugin
+            LSPString key;
+            const bool use_shared   = make_shared_key(&key, fname, af->bCompact) == STATUS_OK;
+            if ((use_shared) && (acquire_shared(af, &key)))
+            {
+                const status_t res      = make_file_thumbnails(af, af->pLoadedPeaks, af->pLoaded);
+                if (res != STATUS_OK)
+                    return res;
+
+                lsp_trace("file successfully loaded from shared memory: %s", fname);
+                af->nLoadedOrigin       = SO_SHARED;
+                return STATUS_OK;
+            }
+
+            // Try to load the sample data from the cache
+            io::Path cache;
+            status_t status         = (af->nCacheLimit > 0) ? make_cache_path(&cache, fname) : STATUS_SKIP;
+            const bool use_cache    = status == STATUS_OK;
+            if (use_cache)
+            {
+                af->nLoadedOrigin       = SO_DISK_CACHE;
+                status                  = load_cached(af, &cache, (use_shared) ? &key : NULL);
+
+                // The partially loaded data is already passed for playback and published by the loader
+                if (atomic_load(&af->nPartial) != PL_NONE)
+                    return status;
+
+                if (status == STATUS_OK)
+                {
+                    lsp_trace("file successfully loaded from cache: %s", cache.as_native());
+                    if (use_shared)
+                        publish_shared(&key, af->pLoaded, af->pLoadedCompact, af->pLoadedPeaks, &af->sLoadedStats);
+                    return STATUS_OK;
+                }
+
+                // Drop any partially loaded data
+                unload_afile(af);
+                af->nLoadedOrigin       = SO_NONE;
+                clear_stats(&af->sLoadedStats);
+            }
+
+            // Load audio file
+            dspu::Sample *source    = new dspu::Sample();
+            if (source == NULL)
+                return STATUS_NO_MEM;
+            lsp_trace("Allocated sample %p", source);
+            lsp_finally { destroy_sample(source); };
+
+            // Load sample
+            status = source->load_ext(fname, meta::referencer::SAMPLE_LENGTH_MAX);
+            if (status != STATUS_OK)
+            {
+                lsp_trace("load failed: status=%d (%s)", status, get_status(status));
+                return status;
+            }
+
+            // Drop unused channels before resampling to not to waste the time
+            const size_t channels   = lsp_min(nChannels, source->channels());
+            if (!source->set_channels(channels))
+            {
+                lsp_trace("failed to resize source sample to %d channels", int(channels));
+                return STATUS_NO_MEM;
+            }
+
+            status = resample_sample(af, source, fSampleRate);
+            if (status != STATUS_OK)
+            {
+                lsp_trace("resampling failed: status=%d (%s)", status, get_status(status));
+                return status;
+            }
+
+            // Analyze the whole file, errors are not critical
+            status = analyze_sample(&af->sLoadedStats, source, fSampleRate);
+            if (status != STATUS_OK)
+            {
+                lsp_trace("failed to analyze sample: status=%d (%s)", status, get_status(status));
+                clear_stats(&af->sLoadedStats);
+            }
+
+            // Build peak pyramid and render thumbnails
+            af->pLoadedPeaks        = create_peaks(channels, source->length());
+            if (af->pLoadedPeaks == NULL)
+                return STATUS_NO_MEM;
+            for (size_t i=0; i<channels; ++i)
+                build_peaks(af->pLoadedPeaks, i, source->channel(i));
+
+            // Precompute analysis timeline of the reference, errors are not critical
+            status = build_timeline(af->pLoadedPeaks, source);
+            if (status != STATUS_OK)
+            {
+                lsp_trace("failed to build analysis timeline: status=%d (%s)", status, get_status(status));
+            }
+
+            status = make_file_thumbnails(af, af->pLoadedPeaks, source);
+            if (status != STATUS_OK)
+                return status;
+            af->nLoadedOrigin       = SO_DECODED;
+
+            // Store the decoded data to the cache, errors are not critical
+            bool cached             = false;
+            if (use_cache)
+            {
+                status                  = save_cached(&cache, af, source);
+                cached                  = (status == STATUS_OK);
+                if (!cached)
+                {
+                    lsp_trace("failed to store sample data to cache: status=%d (%s)", status, get_status(status));
+                }
+            }
+
+            // Move the sample data to the disk if it does not fit into the RAM budget
+            const size_t data_size  = source->length() * channels * ((af->bCompact) ? sizeof(int16_t) : sizeof(float));
+            if (data_size > af->nRamLimit)
+            {
+                status = (cached) ?
+                    stream_file(af, &cache, channels, source->length(), sizeof(cache_header_t) + sizeof(float) * channels * af->pLoadedPeaks->nSize) :
+                    spill_sample(af, source);
+                if (status != STATUS_OK)
+                {
+                    lsp_trace("failed to store sample data: status=%d (%s)", status, get_status(status));
+                    return status;
+                }
+
+                lsp_trace("file successfully loaded for streaming: %s", fname);
+                return STATUS_OK;
+            }
+
+            // Commit the result
+            lsp_trace("file successfully loaded: %s", fname);
+            if (af->bCompact)
+            {
+                status                  = compact_sample(af, source);
+                if (status != STATUS_OK)
+                    return status;
+            }
+            else
+                lsp::swap(af->pLoaded, source);
+
+            // Allow other instances of the plugin to use the loaded data
+            if (use_shared)
+                publish_shared(&key, af->pLoaded, af->pLoadedCompact, af->pLoadedPeaks, &af->sLoadedStats);
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::resample_sample(afile_t *af, dspu::Sample *sample, size_t sample_rate)
+        {
+            const size_t src_rate   = sample->sample_rate();
+            const size_t channels   = sample->channels();
+            const size_t length     = sample->length();
+            if ((src_rate == sample_rate) || (channels <= 1))
+                return sample->resample(sample_rate);
+
+            // The jobs still held by the executor after the previous load can not be reused,
+            // resample all channels in the current thread then
+            for (size_t i=1; i<channels; ++i)
+            {
+                Resampler *job          = af->vResamplers[i - 1];
+                if (job->completed())
+                    job->reset();
+                if (!job->idle())
+                    return sample->resample(sample_rate);
+            }
+
+            // Move all channels except the first one to the jobs
+            lsp_finally {
+                for (size_t i=1; i<channels; ++i)
+                    af->vResamplers[i - 1]->unbind();
+            };
+            for (size_t i=1; i<channels; ++i)
+            {
+                const status_t res      = af->vResamplers[i - 1]->bind(sample->channel(i), length, src_rate, sample_rate);
+                if (res != STATUS_OK)
+                    return res;
+            }
+            if (!sample->set_channels(1))
+                return STATUS_NO_MEM;
+
+            // Jobs are passed to the executor and the first channel is resampled by the current thread.
+            // After that, the jobs not started by the executor yet are processed by the current thread,
+            // and the jobs already started are waited for.
+            for (size_t i=1; i<channels; ++i)
+                pExecutor->submit(af->vResamplers[i - 1]);
+
+            status_t res            = sample->resample(sample_rate);
+            for (size_t i=1; i<channels; ++i)
+            {
+                const status_t code     = af->vResamplers[i - 1]->process();
+                if (res == STATUS_OK)
+                    res                     = code;
+            }
+            if (res != STATUS_OK)
+                return res;
+
+            // Gather the resampled channels
+            const size_t new_length = sample->length();
+            if (!sample->set_channels(channels))
+                return STATUS_NO_MEM;
+            for (size_t i=1; i<channels; ++i)
+            {
+                const dspu::Sample *s   = af->vResamplers[i - 1]->sample();
+                const size_t count      = lsp_min(s->length(), new_length);
+                dsp::copy(sample->channel(i), s->channel(0), count);
+                dsp::fill_zero(sample->channel(i, count), new_length - count);
+            }
+
+            return STATUS_OK;
+        }
+
+        void referencer::clear_stats(file_stats_t *stats)
+        {
+            stats->fPeak            = GAIN_AMP_M_INF_DB;
+            stats->fTruePeak        = GAIN_AMP_M_INF_DB;
+            stats->fILUFS           = GAIN_AMP_M_INF_DB;
+            stats->fLRA             = 0.0f;
+        }
+
+        static int compare_levels(const void *a, const void *b)
+        {
+            const float la          = *static_cast<const float *>(a);
+            const float lb          = *static_cast<const float *>(b);
+            return (la < lb) ? -1 : (la > lb) ? 1 : 0;
+        }
+
+        float referencer::loudness_range(float *levels, size_t count)
+        {
+            // Apply absolute gate (see EBU Tech 3342 for reference)
+            const float abs_gate    = dspu::db_to_gain(LRA_ABS_GATE);
+            double power            = 0.0;
+            size_t gated            = 0;
+            for (size_t i=0; i<count; ++i)
+            {
+                const float level       = levels[i];
+                if (level < abs_gate)
+                    continue;
+                levels[gated++]         = level;
+                power                  += level * level;
+            }
+            if (gated <= 0)
+                return 0.0f;
+
+            // Apply relative gate
+            const float rel_gate    = sqrtf(power / gated) * dspu::db_to_gain(LRA_REL_GATE);
+            count                   = gated;
+            gated                   = 0;
+            for (size_t i=0; i<count; ++i)
+            {
+                if (levels[i] >= rel_gate)
+                    levels[gated++]         = levels[i];
+            }
+            if (gated <= 0)
+                return 0.0f;
+
+            // Compute the distance between low and high percentiles
+            qsort(levels, gated, sizeof(float), compare_levels);
+            const float low         = levels[size_t((gated - 1) * LRA_LOW_PERCENTILE + 0.5f)];
+            const float high        = levels[size_t((gated - 1) * LRA_HIGH_PERCENTILE + 0.5f)];
+
+            return dspu::gain_to_db(high) - dspu::gain_to_db(low);
+        }
+
+        dspu::bs::channel_t referencer::channel_designation(size_t index, size_t channels)
+        {
+            if (channels <= 1)
+                return dspu::bs::CHANNEL_CENTER;
+            return (index == 0) ? dspu::bs::CHANNEL_LEFT : dspu::bs::CHANNEL_RIGHT;
+        }
+
+        status_t referencer::init_loudness_meter(
+            dspu::LoudnessMeter *meter, size_t channels, float max_period, float period, dspu::bs::weighting_t weighting)
+        {
+            const status_t res      = meter->init(channels, max_period);
+            if (res != STATUS_OK)
+                return res;
+
+            meter->set_period(period);
+            meter->set_weighting(weighting);
+            for (size_t i=0; i<channels; ++i)
+            {
+                meter->set_active(i, true);
+                meter->set_designation(i, channel_designation(i, channels));
+            }
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::init_ilufs_meter(
+            dspu::ILUFSMeter *meter, size_t channels, float max_int_time, dspu::bs::weighting_t weighting)
+        {
+            const status_t res      = meter->init(channels, max_int_time, dspu::bs::LUFS_MOMENTARY_PERIOD);
+            if (res != STATUS_OK)
+                return res;
+
+            meter->set_weighting(weighting);
+            for (size_t i=0; i<channels; ++i)
+            {
+                meter->set_active(i, true);
+                meter->set_designation(i, channel_designation(i, channels));
+            }
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::analyze_sample(file_stats_t *stats, const dspu::Sample *sample, size_t sample_rate)
+        {
+            const size_t channels   = sample->channels();
+            const size_t length     = sample->length();
+            const size_t lra_step   = lsp_max(dspu::seconds_to_samples(sample_rate, LRA_BLOCK_PERIOD), size_t(1));
+            const size_t lra_blocks = length / lra_step + 1;
+
+            // Allocate buffers
+            const size_t szof_buf   = align_size(sizeof(float) * STATS_BUFFER_SIZE, OPTIMAL_ALIGN);
+            const size_t szof_lra   = align_size(sizeof(float) * lra_blocks, OPTIMAL_ALIGN);
+            uint8_t *data           = NULL;
+            uint8_t *ptr            = alloc_aligned<uint8_t>(data, szof_buf * 2 + szof_lra, OPTIMAL_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free_aligned(data); };
+
+            float *buf              = advance_ptr_bytes<float>(ptr, szof_buf);
+            float *tmp              = advance_ptr_bytes<float>(ptr, szof_buf);
+            float *levels           = advance_ptr_bytes<float>(ptr, szof_lra);
+
+            // Initialize meters
+            dspu::TruePeakMeter tp_meter;
+            dspu::ILUFSMeter i_meter;
+            dspu::LoudnessMeter s_meter;
+            lsp_finally {
+                tp_meter.destroy();
+                i_meter.destroy();
+                s_meter.destroy();
+            };
+
+            if (!tp_meter.init())
+                return STATUS_NO_MEM;
+            status_t res            = init_ilufs_meter(&i_meter, channels, 0, dspu::bs::WEIGHT_K);
+            if (res != STATUS_OK)
+                return res;
+            res                     = init_loudness_meter(&s_meter, channels, dspu::bs::LUFS_SHORT_TERM_PERIOD,
+                dspu::bs::LUFS_SHORT_TERM_PERIOD, dspu::bs::WEIGHT_K);
+            if (res != STATUS_OK)
+                return res;
+
+            tp_meter.set_sample_rate(sample_rate);
+            i_meter.set_sample_rate(sample_rate);
+            s_meter.set_sample_rate(sample_rate);
+
+            // Compute sample peak and true peak, flush the latency of true peak meter with zeros
+            const size_t latency    = tp_meter.latency();
+            float peak              = 0.0f;
+            float true_peak         = 0.0f;
+            dsp::fill_zero(tmp, STATS_BUFFER_SIZE);
+            for (size_t i=0; i<channels; ++i)
+            {
+                const float *src        = sample->channel(i);
+                peak                    = lsp_max(peak, dsp::abs_max(src, length));
+
+                tp_meter.clear();
+                for (size_t offset=0; offset < length; )
+                {
+                    const size_t count      = lsp_min(length - offset, STATS_BUFFER_SIZE);
+                    tp_meter.process(buf, &src[offset], count);
+                    true_peak               = lsp_max(true_peak, dsp::max(buf, count));
+                    offset                 += count;
+                }
+                for (size_t offset=0; offset < latency; )
+                {
+                    const size_t count      = lsp_min(latency - offset, STATS_BUFFER_SIZE);
+                    tp_meter.process(buf, tmp, count);
+                    true_peak               = lsp_max(true_peak, dsp::max(buf, count));
+                    offset                 += count;
+                }
+            }
+
+            // Compute integrated loudness and pick short-term loudness at regular intervals
+            size_t next             = lsp_max(dspu::millis_to_samples(sample_rate, dspu::bs::LUFS_SHORT_TERM_PERIOD), lra_step) - 1;
+            size_t n_levels         = 0;
+            float loudness          = 0.0f;
+            for (size_t offset=0; offset < length; )
+            {
+                const size_t count      = lsp_min(length - offset, STATS_BUFFER_SIZE);
+                for (size_t i=0; i<channels; ++i)
+                {
+                    i_meter.bind(i, sample->channel(i, offset));
+                    s_meter.bind(i, NULL, sample->channel(i, offset), 0);
+                }
+
+                i_meter.process(buf, count, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                loudness                = buf[count - 1];
+
+                s_meter.process(buf, count, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                for ( ; (next < offset + count) && (n_levels < lra_blocks); next += lra_step)
+                    levels[n_levels++]      = buf[next - offset];
+                if ((offset + count >= length) && (n_levels <= 0))
+                    levels[n_levels++]      = buf[count - 1];
+
+                offset                 += count;
+            }
+
+            stats->fPeak            = peak;
+            stats->fTruePeak        = true_peak;
+            stats->fILUFS           = loudness;
+            stats->fLRA             = loudness_range(levels, n_levels);
+
+            return STATUS_OK;
+        }
+
+        referencer::dsample_t *referencer::create_stream(size_t channels, size_t length, size_t seam)
+        {
+            dsample_t *ds           = new dsample_t;
+            if (ds == NULL)
+                return NULL;
+
+            ds->nChannels           = channels;
+            ds->nLength             = length;
+            ds->nOffset             = 0;
+            ds->bTemporary          = false;
+            ds->nSeamSize           = seam;
+            ds->vScratch            = NULL;
+            ds->pData               = NULL;
+
+            // Allocate prefetch buffers
+            const size_t szof_buf   = align_size(sizeof(float) * STREAM_BUFFER_SIZE, OPTIMAL_ALIGN);
+            const size_t szof_seam  = align_size(sizeof(float) * seam, OPTIMAL_ALIGN);
+            const size_t alloc      = (szof_buf + szof_seam) * channels * meta::referencer::AUDIO_LOOPS + szof_seam;
+            uint8_t *ptr            = alloc_aligned<uint8_t>(ds->pData, alloc, OPTIMAL_ALIGN);
+            if (ptr == NULL)
+            {
+                destroy_stream(ds);
+                return NULL;
+            }
+
+            for (size_t i=0; i<meta::referencer::AUDIO_LOOPS; ++i)
+            {
+                for (size_t j=0; j<meta::referencer::CHANNELS_MAX; ++j)
+                {
+                    ds->vBuffer[i][j]       = (j < channels) ? advance_ptr_bytes<float>(ptr, szof_buf) : NULL;
+                    ds->vSeam[i][j]         = (j < channels) ? advance_ptr_bytes<float>(ptr, szof_seam) : NULL;
+                }
+            }
+            ds->vScratch            = advance_ptr_bytes<float>(ptr, szof_seam);
+
+            return ds;
+        }
+
+        status_t referencer::compact_sample(afile_t *af, const dspu::Sample *sample)
+        {
+            const size_t channels   = sample->channels();
+            csample_t *cs           = create_compact(channels, sample->length());
+            if (cs == NULL)
+                return STATUS_NO_MEM;
+
+            for (size_t i=0; i<channels; ++i)
+                encode_compact(cs, i, sample->channel(i));
+
+            // Commit the result
+            lsp::swap(af->pLoadedCompact, cs);
+            destroy_compact(cs);
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::spill_sample(afile_t *af, const dspu::Sample *sample)
+        {
+            const size_t channels   = sample->channels();
+            const size_t length     = sample->length();
+            dsample_t *ds           = create_stream(channels, length,
+                dspu::millis_to_samples(af->nLoadRate, meta::referencer::CROSSFADE_TIME));
+            if (ds == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_stream(ds); };
+
+            // Generate unique name of the file in the temporary directory
+            LSPString name;
+            system::time_t ts;
+            system::get_time(&ts);
+            if (!name.fmt_ascii("lsp-referencer-%p-%llx-%x.tmp", af, (long long)(ts.seconds), int(ts.nanos)))
+                return STATUS_NO_MEM;
+
+            status_t res            = system::get_temporary_dir(&ds->sPath);
+            if (res == STATUS_OK)
+                res                     = ds->sPath.append_child(&name);
+            if (res != STATUS_OK)
+            {
+                ds->sPath.clear();
+                return res;
+            }
+
+            // Write planar sample data to the file
+            res                     = ds->sFile.open(&ds->sPath, io::File::FM_READWRITE | io::File::FM_CREATE | io::File::FM_TRUNC);
+            if (res != STATUS_OK)
+            {
+                ds->sPath.clear();
+                return res;
+            }
+            ds->bTemporary          = true;
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                res                     = write_fully(&ds->sFile, sample->channel(i), length * sizeof(float));
+                if (res != STATUS_OK)
+                    return res;
+            }
+
+            // Commit the result
+            lsp::swap(af->pLoadedStream, ds);
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::stream_file(afile_t *af, const io::Path *path, size_t channels, size_t length, wsize_t offset)
+        {
+            dsample_t *ds           = create_stream(channels, length,
+                dspu::millis_to_samples(af->nLoadRate, meta::referencer::CROSSFADE_TIME));
+            if (ds == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_stream(ds); };
+
+            status_t res            = ds->sPath.set(path);
+            if (res != STATUS_OK)
+                return res;
+            res                     = ds->sFile.open(&ds->sPath, io::File::FM_READ);
+            if (res != STATUS_OK)
+                return res;
+            ds->nOffset             = offset;
+
+            // Commit the result
+            lsp::swap(af->pLoadedStream, ds);
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::read_fully(io::File *fd, wsize_t pos, void *dst, size_t count)
+        {
+            uint8_t *ptr            = static_cast<uint8_t *>(dst);
+            while (count > 0)
+            {
+                const ssize_t read      = fd->pread(pos, ptr, count);
+                if (read <= 0)
+                    return ((read < 0) && (read != -STATUS_EOF)) ? status_t(-read) : STATUS_CORRUPTED;
+
+                ptr                    += read;
+                pos                    += read;
+                count                  -= read;
+            }
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::write_fully(io::File *fd, const void *src, size_t count)
+        {
+            const uint8_t *ptr      = static_cast<const uint8_t *>(src);
+            while (count > 0)
+            {
+                const ssize_t written   = fd->write(ptr, count);
+                if (written <= 0)
+                    return (written < 0) ? status_t(-written) : STATUS_IO_ERROR;
+
+                ptr                    += written;
+                count                  -= written;
+            }
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::make_cache_path(io::Path *path, const char *fname)
+        {
+            io::fattr_t attr;
+            status_t res            = io::File::stat(fname, &attr);
+            if (res != STATUS_OK)
+                return res;
+
+            // Compute FNV-1a hash of the file name, the file contents are identified by the size and modification time
+            uint64_t hash           = 0xcbf29ce484222325ULL;
+            for (const uint8_t *p = reinterpret_cast<const uint8_t *>(fname); *p != 0; ++p)
+            {
+                hash                   ^= *p;
+                hash                   *= 0x100000001b3ULL;
+            }
+
+            // Form the path to the cache file, the data depends on sample rate and number of channels
+            LSPString name;
+            if (!name.fmt_ascii("%016llx-%llx-%llx-%d-%d.cache",
+                (unsigned long long)(hash), (unsigned long long)(attr.size), (unsigned long long)(attr.mtime),
+                int(fSampleRate), int(nChannels)))
+                return STATUS_NO_MEM;
+
+            res                     = get_cache_dir(path);
+            if (res == STATUS_OK)
+                res                     = path->append_child(&name);
+
+            return res;
+        }
+
+        status_t referencer::get_cache_dir(io::Path *path)
+        {
+            // The cache should survive the reboot, so the temporary directory which is often
+            // located in the RAM is not suitable for it. Use the cache directory of the user.
+            LSPString value;
+            status_t res;
+        #if defined(PLATFORM_WINDOWS)
+            res                     = system::get_env_var("LOCALAPPDATA", &value);
+            if (res == STATUS_OK)
+                res                     = path->set(&value);
+        #elif defined(PLATFORM_MACOSX)
+            res                     = system::get_home_directory(path);
+            if (res == STATUS_OK)
+                res                     = path->append_child("Library/Caches");
+        #else
+            res                     = system::get_env_var("XDG_CACHE_HOME", &value);
+            if (res == STATUS_OK)
+                res                     = path->set(&value);
+            if ((res != STATUS_OK) || (!path->is_absolute()))
+            {
+                res                     = system::get_home_directory(path);
+                if (res == STATUS_OK)
+                    res                     = path->append_child(".cache");
+            }
+        #endif /* PLATFORM_WINDOWS */
+            if (res == STATUS_OK)
+                res                     = path->append_child("lsp-plugins");
+            if (res == STATUS_OK)
+                res                     = path->append_child("referencer");
+
+            return res;
+        }
+
+        status_t referencer::make_shared_key(LSPString *key, const char *fname, bool compact)
+        {
+            io::fattr_t attr;
+            const status_t res      = io::File::stat(fname, &attr);
+            if (res != STATUS_OK)
+                return res;
+
+            // The data depends on the file, sample rate, number of channels and storage format
+            if (!key->fmt_utf8("%s:%llx:%llx:%d:%d:%d",
+                fname, (unsigned long long)(attr.mtime), (unsigned long long)(attr.size),
+                int(fSampleRate), int(nChannels), int(compact)))
+                return STATUS_NO_MEM;
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::load_cached(afile_t *af, const io::Path *path, const LSPString *key)
+        {
+            io::NativeFile fd;
+            status_t res            = fd.open(path, io::File::FM_READ);
+            if (res != STATUS_OK)
+                return res;
+            lsp_finally { fd.close(); };
+
+            // Read and validate the header
+            cache_header_t hdr;
+            res                     = read_fully(&fd, 0, &hdr, sizeof(hdr));
+            if (res != STATUS_OK)
+                return res;
+            if ((memcmp(hdr.vMagic, "LSPR", 4) != 0) ||
+                (hdr.nVersion != CACHE_VERSION) ||
+                (hdr.nSampleRate != fSampleRate) ||
+                (hdr.nChannels <= 0) ||
+                (hdr.nChannels > lsp_min(nChannels, meta::referencer::CHANNELS_MAX)))
+                return STATUS_CORRUPTED;
+
+            // Rewrite the header to update the modification time, eviction removes the least recently used files first
+            io::NativeFile tfd;
+            if (tfd.open(path, io::File::FM_WRITE) == STATUS_OK)
+            {
+                tfd.pwrite(0, &hdr, sizeof(hdr));
+                tfd.close();
+            }
+
+            const size_t channels   = hdr.nChannels;
+            const size_t length     = hdr.nLength;
+            af->sLoadedStats        = hdr.sStats;
+
+            // Read peak pyramid
+            af->pLoadedPeaks        = create_peaks(channels, length);
+            if (af->pLoadedPeaks == NULL)
+                return STATUS_NO_MEM;
+            const size_t szof_peaks = sizeof(float) * af->pLoadedPeaks->nSize;
+            const wsize_t offset    = sizeof(cache_header_t) + szof_peaks * channels;
+            if (hdr.nPeaks != af->pLoadedPeaks->nSize)
+                return STATUS_CORRUPTED;
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                res                     = read_fully(&fd, sizeof(cache_header_t) + szof_peaks * i, af->pLoadedPeaks->vData[i], szof_peaks);
+                if (res != STATUS_OK)
+                    return res;
+            }
+
+            // Read analysis timeline which is stored after the sample data
+            if (hdr.nTimeFrames > 0)
+            {
+                if ((hdr.nTimeChannels <= 0) ||
+                    (hdr.nTimeChannels > meta::referencer::CHANNELS_MAX) ||
+                    (hdr.nTimeFrames != (length + TIMELINE_STEP - 1) / TIMELINE_STEP))
+                    return STATUS_CORRUPTED;
+
+                atimeline_t *tl         = create_timeline(hdr.nTimeChannels, hdr.nTimeFrames);
+                if (tl == NULL)
+                    return STATUS_NO_MEM;
+                af->pLoadedPeaks->pTimeline = tl;
+
+                const size_t szof_tl    = sizeof(float) * tl->nFrames;
+                const wsize_t tl_offset = offset + wsize_t(length) * channels * sizeof(float);
+                for (size_t i=0; i<TL_TOTAL; ++i)
+                {
+                    res                     = read_fully(&fd, tl_offset + szof_tl * i, tl->vData[i], szof_tl);
+                    if (res != STATUS_OK)
+                        return res;
+                }
+            }
+
+            // Stream the data directly from the cache file if it does not fit into the RAM budget
+            if (length * channels * ((af->bCompact) ? sizeof(int16_t) : sizeof(float)) > af->nRamLimit)
+            {
+                res                     = make_file_thumbnails(af, af->pLoadedPeaks, NULL);
+                if (res != STATUS_OK)
+                    return res;
+                return stream_file(af, path, channels, length, offset);
+            }
+
+            // Read the sample data
+            dspu::Sample *sample    = new dspu::Sample();
+            if (sample == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { destroy_sample(sample); };
+
+            if (!sample->init(channels, length, length))
+                return STATUS_NO_MEM;
+            sample->set_sample_rate(fSampleRate);
+
+            // Large samples are passed for playback as soon as the first chunk is read,
+            // the rest of data is read in the background, the cached peak pyramid provides
+            // complete thumbnails from the very beginning
+            if ((!af->bCompact) && (!af->bReloading) && (length > LOAD_CHUNK_SIZE))
+            {
+                res                     = make_file_thumbnails(af, af->pLoadedPeaks, NULL);
+                if (res != STATUS_OK)
+                    return res;
+
+                dspu::Sample *data      = sample;
+                peaks_t *peaks          = af->pLoadedPeaks;
+                for (size_t first=0; first < length; )
+                {
+                    const size_t count      = lsp_min(length - first, LOAD_CHUNK_SIZE);
+                    for (size_t i=0; i<channels; ++i)
+                    {
+                        res                     = read_fully(&fd, offset + (wsize_t(i) * length + first) * sizeof(float), data->channel(i, first), count * sizeof(float));
+                        if (res != STATUS_OK)
+                            return res;
+                    }
+                    first                  += count;
+
+                    // Publish the loaded part, the sample data is not owned by the loader after that
+                    atomic_store(&af->nProgress, uatomic_t(first));
+                    if (sample != NULL)
+                    {
+                        lsp::swap(af->pLoaded, sample);
+                        atomic_store(&af->nPartial, uatomic_t(PL_READY));
+                    }
+                }
+
+                // Allow other instances of the plugin to use the loaded data
+                if (key != NULL)
+                    publish_shared(key, data, NULL, peaks, &af->sLoadedStats);
+
+                return STATUS_OK;
+            }
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                res                     = read_fully(&fd, offset + wsize_t(i) * length * sizeof(float), sample->channel(i), length * sizeof(float));
+                if (res != STATUS_OK)
+                    return res;
+            }
+
+            res                     = make_file_thumbnails(af, af->pLoadedPeaks, sample);
+            if (res != STATUS_OK)
+                return res;
+
+            // Commit the result
+            if (af->bCompact)
+                return compact_sample(af, sample);
+            lsp::swap(af->pLoaded, sample);
+
+            return STATUS_OK;
+        }
+
+        status_t referencer::save_cached(const io::Path *path, afile_t *af, const dspu::Sample *sample)
         {
-            // Load sample
-            lsp_trace("file = %p", af);
-
-            // Validate arguments
-            if ((af == NULL) || (af->pFile == NULL))
-                return STATUS_UNKNOWN_ERR;
+            const size_t channels   = sample->channels();
+            const size_t length     = sample->length();
+            const peaks_t *peaks    = af->pLoadedPeaks;
+            const atimeline_t *tl   = peaks->pTimeline;
+            const size_t tl_frames  = (tl != NULL) ? tl->nFrames : 0;
+            const wsize_t size      = sizeof(cache_header_t) + sizeof(float) * (channels * (peaks->nSize + length) + tl_frames * TL_TOTAL);
+
+            // Create the cache directory and make the room for the new file
+            io::Path dir;
+            status_t res            = path->get_parent(&dir);
+            if (res != STATUS_OK)
+                return res;
+            if (!dir.is_dir())
+            {
+                res                     = dir.mkdir(true);
+                if (res != STATUS_OK)
+                    return res;
+            }
+            evict_cache(&dir, (size < af->nCacheLimit) ? af->nCacheLimit - size : 0);
 
-            unload_afile(af);
+            // Write the data to the temporary file first to not to expose the partially written file
+            LSPString tmp_name, suffix;
+            if ((res = path->get_last(&tmp_name)) != STATUS_OK)
+                return res;
+            if ((!suffix.fmt_ascii(".%p.tmp", af)) || (!tmp_name.append(&suffix)))
+                return STATUS_NO_MEM;
 
-            // Get path
-            plug::path_t *path      = af->pFile->buffer<plug::path_t>();
-            if (path == NULL)
-                return STATUS_UNKNOWN_ERR;
+            io::Path tmp;
+            if ((res = tmp.set(&dir, &tmp_name)) != STATUS_OK)
+                return res;
+
+            io::NativeFile fd;
+            res                     = fd.open(&tmp, io::File::FM_WRITE_NEW);
+            if (res != STATUS_OK)
+                return res;
+
+            cache_header_t hdr;
+            memcpy(hdr.vMagic, "LSPR", 4);
+            hdr.nVersion            = CACHE_VERSION;
+            hdr.nSampleRate         = fSampleRate;
+            hdr.nChannels           = channels;
+            hdr.nLength             = length;
+            hdr.nPeaks              = peaks->nSize;
+            hdr.sStats              = af->sLoadedStats;
+            hdr.nTimeChannels       = (tl != NULL) ? tl->nChannels : 0;
+            hdr.nTimeFrames         = tl_frames;
+
+            res                     = write_fully(&fd, &hdr, sizeof(hdr));
+            for (size_t i=0; (res == STATUS_OK) && (i<channels); ++i)
+                res                     = write_fully(&fd, peaks->vData[i], sizeof(float) * peaks->nSize);
+            for (size_t i=0; (res == STATUS_OK) && (i<channels); ++i)
+                res                     = write_fully(&fd, sample->channel(i), sizeof(float) * length);
+            for (size_t i=0; (res == STATUS_OK) && (i<TL_TOTAL) && (tl != NULL); ++i)
+                res                     = write_fully(&fd, tl->vData[i], sizeof(float) * tl_frames);
+
+            const status_t cres     = fd.close();
+            if (res == STATUS_OK)
+                res                     = cres;
+            if (res == STATUS_OK)
+                res                     = io::File::rename(&tmp, path);
+            if (res != STATUS_OK)
+                io::File::remove(&tmp);
+
+            return res;
+        }
 
-            // Get file name
-            const char *fname   = path->path();
-            if (strlen(fname) <= 0)
-                return STATUS_UNSPECIFIED;
+        int referencer::compare_cache_files(const void *a, const void *b)
+        {
+            const cache_file_t *fa  = *static_cast<const cache_file_t * const *>(a);
+            const cache_file_t *fb  = *static_cast<const cache_file_t * const *>(b);
+            return (fa->nMTime < fb->nMTime) ? -1 : (fa->nMTime > fb->nMTime) ? 1 : 0;
+        }
 
-            // Load audio file
-            dspu::Sample *source    = new dspu::Sample();
-            if (source == NULL)
-                return STATUS_NO_MEM;
-            lsp_trace("Allocated sample %p", source);
-            lsp_finally { destroy_sample(source); };
+        void referencer::evict_cache(const io::Path *path, wsize_t limit)
+        {
+            lltl::parray<cache_file_t> files;
+            lsp_finally {
+                for (size_t i=0, n=files.size(); i<n; ++i)
+                    delete files.uget(i);
+                files.flush();
+            };
+
+            io::Dir dir;
+            if (dir.open(path) != STATUS_OK)
+                return;
 
-            // Load sample
-            status_t status = source->load_ext(fname, meta::referencer::SAMPLE_LENGTH_MAX);
-            if (status != STATUS_OK)
+            // Find the total size of the cache, files being written by other instances are not the part of the cache
+            io::Path item;
+            io::fattr_t attr;
+            LSPString name;
+            wsize_t total           = 0;
+            while (dir.reads(&item, &attr, true) == STATUS_OK)
             {
-                lsp_trace("load failed: status=%d (%s)", status, get_status(status));
-                return status;
+                if (attr.type != io::fattr_t::FT_REGULAR)
+                    continue;
+                if ((item.get_last(&name) != STATUS_OK) || (!name.ends_with_ascii(".cache")))
+                    continue;
+
+                cache_file_t *cf        = new cache_file_t;
+                if (cf == NULL)
+                    return;
+                cf->nMTime              = attr.mtime;
+                cf->nSize               = attr.size;
+                if ((cf->sPath.set(&item) != STATUS_OK) || (!files.add(cf)))
+                {
+                    delete cf;
+                    return;
+                }
+                total                  += attr.size;
             }
-            status = source->resample(fSampleRate);
-            if (status != STATUS_OK)
+            dir.close();
+            if (total <= limit)
+                return;
+
+            // Remove the least recently used files until the cache fits the limit
+            qsort(files.array(), files.size(), sizeof(cache_file_t *), compare_cache_files);
+            for (size_t i=0, n=files.size(); (i<n) && (total > limit); ++i)
             {
-                lsp_trace("resampling failed: status=%d (%s)", status, get_status(status));
-                return status;
+                cache_file_t *cf        = files.uget(i);
+                if (io::File::remove(&cf->sPath) != STATUS_OK)
+                    continue;
+                total                   = (total > cf->nSize) ? total - cf->nSize : 0;
+                lsp_trace("evicted cache file: %s", cf->sPath.as_native());
             }
+        }
 
-            const size_t channels   = lsp_min(nChannels, source->channels());
-            if (!source->set_channels(channels))
+        void referencer::read_stream(dsample_t *ds, float *dst, size_t channel, size_t offset, size_t count)
+        {
+            uint8_t *ptr            = reinterpret_cast<uint8_t *>(dst);
+            wsize_t pos             = ds->nOffset + (wsize_t(channel) * ds->nLength + offset) * sizeof(float);
+
+            for (size_t left = count * sizeof(float); left > 0; )
             {
-                lsp_trace("failed to resize source sample to %d channels", int(channels));
-                return status;
+                const ssize_t read      = ds->sFile.pread(pos, ptr, left);
+                if (read <= 0)
+                {
+                    // Fill the data that can not be read with silence
+                    const size_t done       = count - left / sizeof(float);
+                    dsp::fill_zero(&dst[done], count - done);
+                    return;
+                }
+
+                ptr                    += read;
+                pos                    += read;
+                left                   -= read;
             }
+        }
 
-            // Initialize and render thumbnails
-            float *thumbs           = static_cast<float *>(malloc(sizeof(float) * channels * meta::referencer::FILE_MESH_SIZE));
-            if (thumbs == NULL)
-                return STATUS_NO_MEM;
+        bool referencer::fetch_prefetched(prefetch_t *pf, ssize_t & count)
+        {
+            if (!pf->bValid)
+                return false;
 
-            for (size_t i=0; i<channels; ++i)
+            // Drop the prefetched data which has been skipped due to buffer underrun
+            if (pf->nSkip > 0)
             {
-                af->vThumbs[i]          = thumbs;
-                thumbs                 += meta::referencer::FILE_MESH_SIZE;
-                make_thumbnail(af->vThumbs[i], source->channel(i), source->length(), meta::referencer::FILE_MESH_SIZE);
+                const uint32_t drop     = lsp_min(pf->nSkip, pf->nFill);
+                pf->nHead               = (pf->nHead + drop) % STREAM_BUFFER_SIZE;
+                pf->nFill              -= drop;
+                pf->nSkip              -= drop;
             }
 
-            // Commit the result
-            lsp_trace("file successfully loaded: %s", fname);
-            lsp::swap(af->pLoaded, source);
+            // The prefetched data should be contiguous
+            count                   = lsp_min(count, ssize_t(STREAM_BUFFER_SIZE - pf->nHead));
+            if ((pf->nSkip == 0) && (pf->nFill >= size_t(count)))
+                return true;
 
-            return STATUS_OK;
+            // Buffer underrun, the data will be skipped
+            pf->nSkip              += count;
+            return false;
         }
 
         void referencer::preprocess_audio_channels()
@@ -1427,27 +3530,75 @@ namespace lsp
                 if (path == NULL)
                     continue;
 
-                // If there is new load request and loader is idle, then wake up the loader
-                if ((path->pending()) && (af->pLoader->idle()))
+                // Follow the progress of the partially loaded sample
+                if (atomic_load(&af->nPartial) == PL_COMMITTED)
+                {
+                    af->nValid              = atomic_load(&af->nProgress);
+                    update_loop_seams(af);
+                }
+
+                // If there is new load or reload request and loader is idle, then wake up the loader.
+                // On reload the current sample data is played until the new data is committed.
+                if (((path->pending()) || (af->bReload)) && (af->pLoader->idle()))
                 {
+                    // Each sample is allowed to keep the equal part of the RAM budget
+                    af->nRamLimit   = (size_t(pRamBudget->value()) * 0x100000) / meta::referencer::AUDIO_SAMPLES;
+                    af->nCacheLimit = wsize_t(pCacheBudget->value()) * 0x100000;
+                    af->bCompact    = pSampleStorage->value() >= 0.5f;
+                    af->nLoadRate   = fSampleRate;
+
                     // Try to submit task
                     if (pExecutor->submit(af->pLoader))
                     {
                         af->nStatus     = STATUS_LOADING;
                         lsp_trace("successfully submitted loader task");
-                        path->accept();
+                        af->bReloading  = !path->pending();
+                        af->bReload     = false;
+                        if (path->pending())
+                            path->accept();
                     }
                 }
-                else if ((path->accepted()) && (af->pLoader->completed()))
+                else if (((path->accepted()) || (af->bReloading)) && (af->pLoader->completed()) && (pStreamer->idle()))
                 {
-                    // Commit the result and trigger for sync
-                    lsp::swap(af->pLoaded, af->pSample);
-                    af->nStatus             = af->pLoader->code();
-                    af->nLength             = (af->nStatus == STATUS_OK) ? af->pSample->length() : 0;
-                    af->bSync               = true;
+                    const uint32_t old_length   = af->nLength;
+                    const bool reloaded         = af->bReloading;
+
+                    // Commit the result and trigger for sync, the partially loaded data is already committed
+                    if (atomic_load(&af->nPartial) == PL_COMMITTED)
+                    {
+                        af->nStatus             = af->pLoader->code();
+                        if (af->nStatus != STATUS_OK)
+                        {
+                            // Detach the partially loaded data, it is destroyed by the next load
+                            unload_afile(af);
+                            commit_file(af, af->nStatus);
+                        }
+                        af->bSync               = true;
+                    }
+                    else
+                        commit_file(af, af->pLoader->code());
+                    af->nValid              = af->nLength;
+                    atomic_store(&af->nPartial, uatomic_t(PL_NONE));
+
+                    // Keep the playback position on reload
+                    if ((reloaded) && (old_length > 0))
+                    {
+                        for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+                        {
+                            loop_t *al              = &af->vLoops[j];
+                            if (al->nPos >= 0)
+                                al->nPos                = (wsize_t(al->nPos) * af->nLength) / old_length;
+                        }
+                    }
+
+                    // The sample rate could change while loading, reload the data again then
+                    if ((af->nStatus == STATUS_OK) && (af->nLoadRate != uint32_t(fSampleRate)))
+                        af->bReload             = true;
 
                     // Now we can surely commit changes and reset task state
-                    path->commit();
+                    if (!reloaded)
+                        path->commit();
+                    af->bReloading          = false;
                     af->pLoader->reset();
 
                     // Update loop range to make not possible to go out of sample memory region
@@ -1456,6 +3607,297 @@ namespace lsp
                     update_playback_state();
                     update_loop_ranges();
                 }
+                else if ((path->accepted()) && (atomic_load(&af->nPartial) == PL_READY) && (pStreamer->idle()))
+                {
+                    // The head of the sample is loaded, start playback while the loader reads the rest of data
+                    commit_file(af, STATUS_OK);
+                    af->nStatus             = STATUS_LOADING;
+                    af->nValid              = atomic_load(&af->nProgress);
+                    atomic_store(&af->nPartial, uatomic_t(PL_COMMITTED));
+
+                    if (i == nPlaySample)
+                        bSyncLoopMesh   = true;
+                    update_playback_state();
+                    update_loop_ranges();
+                }
+            }
+        }
+
+        const referencer::loop_t *referencer::find_timeline_loop(const afile_t **file)
+        {
+            if (!bRefTimeline)
+                return NULL;
+
+            // The timeline is used only when the single loop is playing without transitions
+            const afile_t *af       = NULL;
+            const loop_t *al        = NULL;
+            for (size_t i=0; i<meta::referencer::AUDIO_SAMPLES; ++i)
+            {
+                for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+                {
+                    const loop_t *l         = &vSamples[i].vLoops[j];
+                    if (l->nState == PB_OFF)
+                        continue;
+                    if ((al != NULL) || (l->nState != PB_ACTIVE))
+                        return NULL;
+                    af                      = &vSamples[i];
+                    al                      = l;
+                }
+            }
+            if (al == NULL)
+                return NULL;
+
+            // Check that the timeline matches the sample data and the loop
+            if ((af->nLength <= 0) || (af->nValid < af->nLength) || (af->pPeaks == NULL))
+                return NULL;
+            const atimeline_t *tl   = af->pPeaks->pTimeline;
+            if ((tl == NULL) || (tl->nChannels != nChannels))
+                return NULL;
+            if ((al->nStart < 0) || (al->nEnd - al->nStart < ssize_t(nCrossfadeTime * 2)))
+                return NULL;
+            if (size_t(al->nEnd) > tl->nFrames * TIMELINE_STEP)
+                return NULL;
+
+            // The loop should be longer than the window of the meters, otherwise they are
+            // always affected by the audio preceding the wrap position
+            const ssize_t window    = dspu::millis_to_samples(fSampleRate, dspu::bs::LUFS_SHORT_TERM_PERIOD);
+            if (al->nEnd - al->nStart <= window)
+                return NULL;
+
+            *file                   = af;
+            return al;
+        }
+
+        uint32_t referencer::fetch_reference_timeline(size_t samples)
+        {
+            const afile_t *af       = NULL;
+            const loop_t *al        = find_timeline_loop(&af);
+            if (al == NULL)
+            {
+                pTimelineLoop           = NULL;
+                return TM_NONE;
+            }
+
+            // The values of the timeline are integrated over the audio preceding the position in the file.
+            // They match the live meters only after the meter window of continuous playback since the start
+            // of the loop or the last wrap. Continuity breaks if the loop has been changed or repositioned.
+            const atimeline_t *tl   = af->pPeaks->pTimeline;
+            const ssize_t window    = dspu::millis_to_samples(fSampleRate, dspu::bs::LUFS_SHORT_TERM_PERIOD);
+            if ((al != pTimelineLoop) || (al->nPos != nTimelinePos))
+                nTimelineRun            = 0;
+
+            const ssize_t start     = lsp_limit(al->nPos, al->nStart, al->nEnd - 1);
+            const bool valid        = (ssize_t(nTimelineRun) >= window);
+            bool wrap               = false;
+            ssize_t pos             = start;
+            for (size_t offset=0; offset < samples; )
+            {
+                const size_t count      = lsp_min(samples - offset, size_t(al->nEnd - pos));
+                offset                 += count;
+                pos                    += count;
+                nTimelineRun            = lsp_min(nTimelineRun + count, size_t(window));
+                if (pos >= al->nEnd)
+                {
+                    pos                     = al->nStart;
+                    nTimelineRun            = 0;
+                    wrap                    = true;
+                }
+            }
+            pTimelineLoop           = al;
+            nTimelinePos            = pos;
+
+            if ((!valid) || (wrap))
+                return TM_NONE;
+
+            // Fetch the values following the playback position
+            for (size_t i=0; i<TL_TOTAL; ++i)
+            {
+                expand_timeline(vTimeline[i], tl->vData[i], start, samples);
+                dsp::mul_k2(vTimeline[i], af->fGain, samples);
+            }
+
+            // Live meters should be fed with the last window of the loop to be valid after the wrap
+            return (pos + window <= al->nEnd) ? TM_SHOW | TM_SKIP : TM_SHOW;
+        }
+
+        void referencer::commit_file(afile_t *af, status_t code)
+        {
+            lsp::swap(af->pLoaded, af->pSample);
+            lsp::swap(af->pLoadedStream, af->pStream);
+            lsp::swap(af->pLoadedCompact, af->pCompact);
+            lsp::swap(af->pLoadedPeaks, af->pPeaks);
+            af->nStatus             = code;
+            if (af->nStatus == STATUS_OK)
+            {
+                if (af->pSample != NULL)
+                {
+                    af->nLength             = af->pSample->length();
+                    af->nChannels           = af->pSample->channels();
+                }
+                else if (af->pCompact != NULL)
+                {
+                    af->nLength             = af->pCompact->nLength;
+                    af->nChannels           = af->pCompact->nChannels;
+                }
+                else
+                {
+                    af->nLength             = af->pStream->nLength;
+                    af->nChannels           = af->pStream->nChannels;
+                }
+                af->nOrigin             = af->nLoadedOrigin;
+                af->sStats              = af->sLoadedStats;
+            }
+            else
+            {
+                af->nLength             = 0;
+                af->nChannels           = 0;
+                af->nOrigin             = SO_NONE;
+                clear_stats(&af->sStats);
+            }
+            af->bSync               = true;
+
+            // Drop all prefetched data and loop seams
+            for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+            {
+                loop_t *al              = &af->vLoops[j];
+                prefetch_t *pf          = &al->sPrefetch;
+                pf->bValid              = false;
+                pf->bSeam               = false;
+                al->bSeam               = false;
+            }
+        }
+
+        void referencer::process_stream_requests()
+        {
+            // Commit the prefetched data
+            if (pStreamer->completed())
+            {
+                for (size_t i=0; i<meta::referencer::AUDIO_SAMPLES; ++i)
+                {
+                    afile_t *af         = &vSamples[i];
+                    for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+                    {
+                        prefetch_t *pf      = &af->vLoops[j].sPrefetch;
+                        if (pf->bValid)
+                        {
+                            pf->nFill          += pf->nRequest;
+                            if (pf->nSeam > 0)
+                                pf->bSeam           = true;
+                        }
+                        pf->nRequest        = 0;
+                        pf->nSeam           = 0;
+                    }
+                }
+
+                pStreamer->reset();
+            }
+
+            if (!pStreamer->idle())
+                return;
+
+            // Form new prefetch requests
+            bool submit         = false;
+            for (size_t i=0; i<meta::referencer::AUDIO_SAMPLES; ++i)
+            {
+                afile_t *af         = &vSamples[i];
+                if (af->pStream == NULL)
+                    continue;
+
+                for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+                {
+                    loop_t *al          = &af->vLoops[j];
+                    prefetch_t *pf      = &al->sPrefetch;
+                    if ((al->nStart < 0) || (al->nEnd < 0) || (al->nEnd - al->nStart < ssize_t(nCrossfadeTime * 2)))
+                    {
+                        pf->bValid          = false;
+                        pf->bSeam           = false;
+                        continue;
+                    }
+
+                    if (!pf->bValid)
+                    {
+                        // Start prefetching from the current playback position
+                        pf->nHead           = 0;
+                        pf->nFill           = 0;
+                        pf->nSkip           = 0;
+                        pf->nStart          = al->nStart;
+                        pf->nEnd            = al->nEnd;
+                        pf->nPos            = lsp_limit(al->nPos, al->nStart, al->nEnd - 1);
+                        pf->nSeam           = (nCrossfadeTime <= af->pStream->nSeamSize) ? nCrossfadeTime : 0;
+                        pf->bValid          = true;
+                        pf->bSeam           = false;
+                    }
+                    else if ((pf->nSkip > 0) && (pf->nFill == 0))
+                    {
+                        // Skip the data that has not been prefetched in time
+                        const int32_t length= pf->nEnd - pf->nStart;
+                        pf->nPos            = pf->nStart + (pf->nPos - pf->nStart + pf->nSkip) % length;
+                        pf->nHead           = 0;
+                        pf->nSkip           = 0;
+                    }
+
+                    // Request data if there is enough free space in the buffer
+                    const uint32_t free = uint32_t(STREAM_BUFFER_SIZE) - pf->nFill;
+                    if (free >= STREAM_BUFFER_SIZE / 2)
+                    {
+                        pf->nTail           = (pf->nHead + pf->nFill) % STREAM_BUFFER_SIZE;
+                        pf->nRequest        = free;
+                    }
+                    if ((pf->nRequest > 0) || (pf->nSeam > 0))
+                        submit              = true;
+                }
+            }
+
+            if ((!submit) || (pExecutor->submit(pStreamer)))
+                return;
+
+            // Failed to submit the task, cancel all requests
+            for (size_t i=0; i<meta::referencer::AUDIO_SAMPLES; ++i)
+            {
+                afile_t *af         = &vSamples[i];
+                for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+                    af->vLoops[j].sPrefetch.nRequest    = 0;
+            }
+        }
+
+        void referencer::stream_samples()
+        {
+            for (size_t i=0; i<meta::referencer::AUDIO_SAMPLES; ++i)
+            {
+                afile_t *af         = &vSamples[i];
+                dsample_t *ds       = af->pStream;
+                if (ds == NULL)
+                    continue;
+
+                for (size_t j=0; j<meta::referencer::AUDIO_LOOPS; ++j)
+                {
+                    prefetch_t *pf      = &af->vLoops[j].sPrefetch;
+
+                    // Read the head and the tail of the loop and cross-fade them
+                    if (pf->nSeam > 0)
+                    {
+                        for (size_t k=0; k<ds->nChannels; ++k)
+                        {
+                            read_stream(ds, ds->vSeam[j][k], k, pf->nStart, pf->nSeam);
+                            read_stream(ds, ds->vScratch, k, pf->nEnd - pf->nSeam, pf->nSeam);
+                            make_loop_seam(ds->vSeam[j][k], ds->vSeam[j][k], ds->vScratch, 0, pf->nSeam, pf->nSeam);
+                        }
+                    }
+
+                    // Read the loop data into the ring buffer
+                    for (uint32_t left = pf->nRequest, tail = pf->nTail; left > 0; )
+                    {
+                        const uint32_t count    = lsp_min(lsp_min(left, uint32_t(STREAM_BUFFER_SIZE - tail)), uint32_t(pf->nEnd - pf->nPos));
+                        for (size_t k=0; k<ds->nChannels; ++k)
+                            read_stream(ds, &ds->vBuffer[j][k][tail], k, pf->nPos, count);
+
+                        left               -= count;
+                        tail                = (tail + count) % STREAM_BUFFER_SIZE;
+                        pf->nPos           += count;
+                        if (pf->nPos >= pf->nEnd)
+                            pf->nPos            = pf->nStart;
+                    }
+                }
             }
         }
 
@@ -1474,13 +3916,23 @@ namespace lsp
                 // Output information about the file
                 af->pLength->set_value(dspu::samples_to_seconds(fSampleRate, af->nLength));
                 af->pStatus->set_value(af->nStatus);
-
-                // Transfer file thumbnails to mesh
+                af->pOrigin->set_value(af->nOrigin);
+                af->pPeak->set_value(af->sStats.fPeak);
+                af->pTruePeak->set_value(af->sStats.fTruePeak);
+                af->pILUFS->set_value(af->sStats.fILUFS);
+                af->pLRA->set_value(af->sStats.fLRA);
+                af->pPLR->set_value((af->sStats.fILUFS > 0.0f) ? af->sStats.fTruePeak / af->sStats.fILUFS : GAIN_AMP_0_DB);
+
+                // Transfer file thumbnails to mesh, postpone the transfer until the UI is connected
+                if (!ui_active())
+                    continue;
                 plug::mesh_t *mesh  = reinterpret_cast<plug::mesh_t *>(af->pMesh->buffer());
-                if ((mesh == NULL) || (!mesh->isEmpty()) || (!af->bSync) || (!af->pLoader->idle()))
+                if ((mesh == NULL) || (!mesh->isEmpty()) || (!af->bSync))
+                    continue;
+                if ((!af->pLoader->idle()) && (atomic_load(&af->nPartial) != PL_COMMITTED))
                     continue;
 
-                const size_t channels   = (af->pSample != NULL) ? af->pSample->channels() : 0;
+                const size_t channels   = af->nChannels;
                 if (channels > 0)
                 {
                     // Copy thumbnails
@@ -1496,41 +3948,110 @@ namespace lsp
             }
         }
 
-        void referencer::output_loop_data()
+        void referencer::output_loop_data()
+        {
+            afile_t *af             = &vSamples[nPlaySample];
+            loop_t *al              = &af->vLoops[nPlayLoop];
+
+            const ssize_t limit     = af->nLength;
+            const size_t channels   = af->nChannels;
+
+            const ssize_t start     = lsp_limit(al->nStart, 0, limit);
+            const ssize_t end       = lsp_limit(al->nEnd, 0, limit);
+            const size_t len        = ((al->nEnd >= 0) && (al->nStart >= 0)) ? end - start : 0;
+
+            pLoopLen->set_value(dspu::samples_to_seconds(fSampleRate, len));
+            pLoopPos->set_value(dspu::samples_to_seconds(fSampleRate, al->nPos - al->nStart));
+
+            if ((!bSyncLoopMesh) || (!ui_active()))
+                return;
+
+            // Transfer file thumbnails to mesh
+            plug::mesh_t *mesh  = reinterpret_cast<plug::mesh_t *>(pLoopMesh->buffer());
+            if ((mesh == NULL) || (!mesh->isEmpty()))
+                return;
+
+            if ((channels > 0) && (al->nEnd >= 0) && (al->nStart >= 0))
+            {
+                // Render thumbnails
+                for (size_t i=0; i<channels; ++i)
+                    render_thumbnail(mesh->pvData[i], af->pPeaks, (af->nValid >= af->nLength) ? af->pSample : NULL, i, start, len, meta::referencer::FILE_MESH_SIZE);
+
+                mesh->data(channels, meta::referencer::FILE_MESH_SIZE);
+            }
+            else
+                mesh->data(0, 0);
+
+            bSyncLoopMesh           = false;
+        }
+
+        void referencer::make_loop_seam(float *dst, const float *head, const float *tail, size_t offset, size_t count, size_t length)
+        {
+            dsp::lin_inter_mul3(
+                dst, head,
+                0, GAIN_AMP_M_INF_DB, length, GAIN_AMP_0_DB,
+                offset, count);
+            dsp::lin_inter_fmadd2(
+                dst, tail,
+                0, GAIN_AMP_0_DB, length, GAIN_AMP_M_INF_DB,
+                offset, count);
+        }
+
+        void referencer::update_loop_seam(afile_t *af, loop_t *al)
+        {
+            al->bSeam               = false;
+            if (((af->pSample == NULL) && (af->pCompact == NULL)) || (nCrossfadeTime > LOOP_SEAM_SIZE))
+                return;
+            if ((al->nStart < 0) || (al->nEnd - al->nStart < ssize_t(nCrossfadeTime * 2)))
+                return;
+            if (al->nEnd > ssize_t(af->nValid))
+                return;
+
+            // Each output channel refers to its own channel of the sample
+            const size_t s_channels = af->nChannels;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const size_t s_channel  = i % s_channels;
+                if (af->pCompact != NULL)
+                {
+                    decode_compact(al->vSeam[i], af->pCompact, s_channel, al->nStart, nCrossfadeTime, GAIN_AMP_0_DB);
+                    decode_compact(vSeamBuffer, af->pCompact, s_channel, al->nEnd - nCrossfadeTime, nCrossfadeTime, GAIN_AMP_0_DB);
+                    make_loop_seam(al->vSeam[i], al->vSeam[i], vSeamBuffer, 0, nCrossfadeTime, nCrossfadeTime);
+                }
+                else
+                {
+                    const float *src        = af->pSample->channel(s_channel);
+                    make_loop_seam(al->vSeam[i], &src[al->nStart], &src[al->nEnd - nCrossfadeTime], 0, nCrossfadeTime, nCrossfadeTime);
+                }
+            }
+
+            al->bSeam               = true;
+        }
+
+        void referencer::update_loop_seams(afile_t *af)
         {
-            afile_t *af             = &vSamples[nPlaySample];
-            loop_t *al              = &af->vLoops[nPlayLoop];
-
-            const ssize_t limit     = (af->pSample != NULL) ? af->pSample->length() : 0;
-            const size_t channels   = (af->pSample != NULL) ? af->pSample->channels() : 0;
-
-            const ssize_t start     = lsp_limit(al->nStart, 0, limit);
-            const ssize_t end       = lsp_limit(al->nEnd, 0, limit);
-            const size_t len        = ((al->nEnd >= 0) && (al->nStart >= 0)) ? end - start : 0;
-
-            pLoopLen->set_value(dspu::samples_to_seconds(fSampleRate, len));
-            pLoopPos->set_value(dspu::samples_to_seconds(fSampleRate, al->nPos - al->nStart));
-
-            if (!bSyncLoopMesh)
-                return;
+            for (size_t i=0; i<meta::referencer::AUDIO_LOOPS; ++i)
+            {
+                loop_t *al              = &af->vLoops[i];
+                if (!al->bSeam)
+                    update_loop_seam(af, al);
+            }
+        }
 
-            // Transfer file thumbnails to mesh
-            plug::mesh_t *mesh  = reinterpret_cast<plug::mesh_t *>(pLoopMesh->buffer());
-            if ((mesh == NULL) || (!mesh->isEmpty()))
-                return;
+        void referencer::render_loop_seam(float *dst, afile_t *af, loop_t *al, size_t channel, size_t offset, size_t count)
+        {
+            const ssize_t head      = al->nStart + offset;
+            const ssize_t tail      = al->nEnd - nCrossfadeTime + offset;
 
-            if ((channels > 0) && (al->nEnd >= 0) && (al->nStart >= 0))
+            if (af->pCompact != NULL)
             {
-                // Copy thumbnails
-                for (size_t i=0; i<channels; ++i)
-                    make_thumbnail(mesh->pvData[i], af->pSample->channel(i, start), len, meta::referencer::FILE_MESH_SIZE);
-
-                mesh->data(channels, meta::referencer::FILE_MESH_SIZE);
+                float *buf              = &dst[BUFFER_SIZE];
+                decode_compact(dst, af->pCompact, channel, head, count, GAIN_AMP_0_DB);
+                decode_compact(buf, af->pCompact, channel, tail, count, GAIN_AMP_0_DB);
+                make_loop_seam(dst, dst, buf, offset, count, nCrossfadeTime);
             }
             else
-                mesh->data(0, 0);
-
-            bSyncLoopMesh           = false;
+                make_loop_seam(dst, af->pSample->channel(channel, head), af->pSample->channel(channel, tail), offset, count, nCrossfadeTime);
         }
 
         void referencer::render_loop(afile_t *af, loop_t *al, size_t samples)
@@ -1542,8 +4063,13 @@ namespace lsp
             if (length < nCrossfadeTime * 2)
                 return;
 
-            const size_t s_channels = af->pSample->channels();
+            const size_t s_channels = af->nChannels;
             const float gain        = af->fGain;
+            const size_t loop_id    = al - af->vLoops;
+            dsample_t *ds           = af->pStream;
+            const csample_t *cs     = af->pCompact;
+            prefetch_t *pf          = &al->sPrefetch;
+            bool fetched            = true;
             al->nPos                = lsp_limit(al->nPos, al->nStart, al->nEnd - 1);
 
             // Process loop playback
@@ -1555,34 +4081,74 @@ namespace lsp
                 ssize_t step_size   = (al->nState == PB_ACTIVE) ? samples - offset : lsp_min(nCrossfadeTime - al->nTransition, samples - offset);
                 to_process          = lsp_min(al->nEnd - al->nPos, step_size);
 
+                const ssize_t rel_pos   = al->nPos - al->nStart;
+
                 // Compute how many data we can do
-                if ((!al->bFirst) && (al->nPos < ssize_t(nCrossfadeTime)))
+                // The head of the loop is cross-faded with the tail and stored in the seam buffer
+                // The seam of in-memory sample is cross-faded in place if the seam buffer is not ready
+                crossfade           = (!al->bFirst) && (rel_pos < ssize_t(nCrossfadeTime));
+                if (ds != NULL)
+                    crossfade           = (crossfade) && (pf->bSeam);
+                else
+                    crossfade           = (crossfade) && ((al->bSeam) || (al->nEnd <= ssize_t(af->nValid)));
+                if (crossfade)
+                    to_process          = lsp_min(ssize_t(nCrossfadeTime) - rel_pos, to_process);
+                if (ds != NULL)
+                    fetched             = fetch_prefetched(pf, to_process);
+                else if (crossfade)
+                    fetched             = true;
+                else
                 {
-                    // We need to render cross-fade first
-                    to_process          = lsp_min(ssize_t(nCrossfadeTime) - al->nPos, to_process);
-                    crossfade           = true;
+                    // The sample data is still being loaded, output silence past the loaded part
+                    const ssize_t valid     = ssize_t(af->nValid) - al->nPos;
+                    fetched                 = valid > 0;
+                    if (fetched)
+                        to_process              = lsp_min(valid, to_process);
                 }
-                else
-                    crossfade           = false;
 
                 // Process each channel independently
                 for (size_t i=0; i<nChannels; ++i)
                 {
                     // Obtain source and destination pointers
                     float *dst          = &vChannels[i].vBuffer[offset];
-                    const float *src    = af->pSample->channel(i % s_channels, al->nPos);
-                    if (crossfade)
+                    const float *src;
+                    if (!fetched)
+                    {
+                        // Sample data is not ready yet, output silence
+                        dsp::fill_zero(vBuffer, to_process);
+                        src                 = vBuffer;
+                    }
+                    else if (ds != NULL)
+                    {
+                        const size_t s_channel  = i % s_channels;
+                        if (crossfade)
+                            src                 = &ds->vSeam[loop_id][s_channel][rel_pos];
+                        else
+                            src                 = &ds->vBuffer[loop_id][s_channel][pf->nHead];
+                    }
+                    else if (crossfade)
+                    {
+                        if (al->bSeam)
+                            src                 = &al->vSeam[i][rel_pos];
+                        else
+                        {
+                            render_loop_seam(vBuffer, af, al, i % s_channels, rel_pos, to_process);
+                            src                 = vBuffer;
+                        }
+                    }
+                    else if (cs != NULL)
                     {
-                        dsp::lin_inter_mul3(
-                            vBuffer, src,
-                            0, GAIN_AMP_M_INF_DB, nCrossfadeTime, GAIN_AMP_0_DB,
-                            al->nPos, to_process);
-                        dsp::lin_inter_fmadd2(
-                            vBuffer, &src[al->nEnd + al->nPos - nCrossfadeTime],
-                            0, GAIN_AMP_0_DB, nCrossfadeTime, GAIN_AMP_M_INF_DB,
-                            al->nPos, to_process);
+                        // Decode the compact sample data, the gain of the active loop is applied at once
+                        if (al->nState == PB_ACTIVE)
+                        {
+                            decode_compact(dst, cs, i % s_channels, al->nPos, to_process, gain);
+                            continue;
+                        }
+                        decode_compact(vBuffer, cs, i % s_channels, al->nPos, to_process, GAIN_AMP_0_DB);
                         src                 = vBuffer;
                     }
+                    else
+                        src                 = af->pSample->channel(i % s_channels, al->nPos);
 
                     // Now we can process the sample
                     switch (al->nState)
@@ -1608,6 +4174,13 @@ namespace lsp
                     }
                 }
 
+                // Release the consumed prefetched data
+                if ((ds != NULL) && (fetched))
+                {
+                    pf->nHead       = (pf->nHead + to_process) % STREAM_BUFFER_SIZE;
+                    pf->nFill      -= to_process;
+                }
+
                 // Update positions
                 switch (al->nState)
                 {
@@ -1656,7 +4229,7 @@ namespace lsp
                     loop_t *al = &af->vLoops[j];
 
                     // Check that file contains sample
-                    if (af->pSample == NULL)
+                    if (af->nLength == 0)
                     {
                         al->nPos        = -1;
                         break;
@@ -1806,6 +4379,34 @@ namespace lsp
             }
         }
 
+        void referencer::reduce_stereo_spectrum(float *dl, float *dr, const float *re, const float *im, size_t rank)
+        {
+            // The spectrum Z of the complex signal L + j*R is split into spectra of
+            // the real signals L and R using the symmetry of the real-valued FFT:
+            //   L[k] = (Z[k] + conj(Z[N-k])) / 2
+            //   R[k] = (Z[k] - conj(Z[N-k])) / 2j
+            const size_t mask   = (size_t(1) << rank) - 1;
+
+            for (size_t i=0; i<meta::referencer::SPC_MESH_SIZE; ++i)
+            {
+                const size_t k      = vFftInds[i];
+                const size_t nk     = (-k) & mask;
+
+                const float a       = re[k];
+                const float b       = im[k];
+                const float c       = re[nk];
+                const float d       = im[nk];
+
+                dl[0]               = 0.5f * (a + c);
+                dl[1]               = 0.5f * (b - d);
+                dr[0]               = 0.5f * (b + d);
+                dr[1]               = 0.5f * (c - a);
+
+                dl                 += 2;
+                dr                 += 2;
+            }
+        }
+
         void referencer::reset_fft()
         {
             const size_t max_graph  = (nChannels > 1) ? FG_STEREO : FG_MONO;
@@ -1871,8 +4472,39 @@ namespace lsp
                 const ssize_t findex = logf(fFftFreq/SPEC_FREQ_MIN) * (meta::referencer::SPC_MESH_SIZE-1) / logf(SPEC_FREQ_MAX / SPEC_FREQ_MIN);
                 const float level = ((findex >= 0) && (size_t(findex) < meta::referencer::SPC_MESH_SIZE)) ?
                         fg->vData[FT_CURR][findex] * vFftEnvelope[findex] : GAIN_AMP_M_INF_DB;
-                pFftVMarkVal->set_value(level);
+                fFftVMarkVal        = level;
+            }
+        }
+
+        uint32_t referencer::fft_period(size_t refresh, size_t fft_size) const
+        {
+            size_t period;
+            switch (refresh)
+            {
+                case FR_ECONOMY:
+                    // Lower the refresh rate for large FFT sizes to keep the overlap not more than 50%
+                    period      = lsp_max(size_t(dspu::hz_to_samples(fSampleRate, meta::referencer::SPC_REFRESH_RATE)), fft_size >> 1);
+                    break;
+                case FR_5HZ:        period      = dspu::hz_to_samples(fSampleRate, 5.0f); break;
+                case FR_10HZ:       period      = dspu::hz_to_samples(fSampleRate, 10.0f); break;
+                case FR_30HZ:       period      = dspu::hz_to_samples(fSampleRate, 30.0f); break;
+                case FR_60HZ:       period      = dspu::hz_to_samples(fSampleRate, 60.0f); break;
+                case FR_OVERLAP_50: period      = fft_size >> 1; break;
+                case FR_OVERLAP_75: period      = fft_size >> 2; break;
+                case FR_20HZ:
+                default:
+                    period      = dspu::hz_to_samples(fSampleRate, meta::referencer::SPC_REFRESH_RATE);
+                    break;
             }
+
+            return lsp_max(period, size_t(1));
+        }
+
+        uint32_t referencer::fft_frame_phase(uint32_t period, size_t index)
+        {
+            // Mix and reference frames are shifted by half of the period, so they never
+            // are processed at the same time when the block is shorter than half of the period
+            return (period * index) >> 1;
         }
 
         void referencer::process_fft_frame(fft_meters_t *fm)
@@ -1885,7 +4517,7 @@ namespace lsp
             if (nChannels > 1)
             {
                 // Stereo processing
-                float *fl       = vBuffer;
+                float *fl       = fm->vAnBuffer;
                 float *fr       = &fl[fft_xsize];
                 float *ft1      = &fr[fft_xsize];
                 float *ft2      = &ft1[fft_xsize];
@@ -1905,14 +4537,9 @@ namespace lsp
                     dsp::mul3(&fr[split], &fm->vHistory[1][0], &vFftWindow[split], fft_size - split);
                 }
 
-                // Perform FFT transform
-                dsp::pcomplex_r2c(ft1, fl, fft_size);
-                dsp::packed_direct_fft(ft1, ft1, nFftRank);
-                reduce_cspectrum(fl, ft1);
-
-                dsp::pcomplex_r2c(ft1, fr, fft_size);
-                dsp::packed_direct_fft(ft1, ft1, nFftRank);
-                reduce_cspectrum(fr, ft1);
+                // Perform one complex FFT transform for both channels and separate spectra
+                dsp::direct_fft(ft1, ft2, fl, fr, nFftRank);
+                reduce_stereo_spectrum(fl, fr, ft1, ft2, nFftRank);
 
                 // Analyze Mid and side signals
                 dsp::lr_to_ms(ft1, ft2, fl, fr, meta::referencer::SPC_MESH_SIZE * 2);
@@ -1941,7 +4568,7 @@ namespace lsp
             }
             else
             {
-                float *fl       = vBuffer;
+                float *fl       = fm->vAnBuffer;
                 float *ft1      = &fl[fft_xsize];
 
                 // Prepare buffers
@@ -1997,28 +4624,53 @@ namespace lsp
 
         void referencer::perform_metering(dyna_meters_t *dm, const float *l, const float *r, size_t samples)
         {
-            float *b1       = vBuffer;
-            float *b2       = &vBuffer[BUFFER_SIZE];
+            float *b1       = dm->vAnBuffer;
+            float *b2       = &dm->vAnBuffer[BUFFER_SIZE];
+            float *kl       = &dm->vAnBuffer[BUFFER_SIZE * 2];
+            float *kr       = &dm->vAnBuffer[BUFFER_SIZE * 3];
             float *in[2];
             in[0]           = const_cast<float *>(l);
             in[1]           = const_cast<float *>(r);
 
+            // Peak values, long-term and integrated loudness are accumulated over time
+            // and are computed regardless of the demand
+            const uint32_t demand   = dm->nDemand;
+
             if (nChannels > 1)
             {
-                // Capture waveform for left and right
-                dm->vWaveform[WF_LEFT].push(l, samples);
-                dm->vWaveform[WF_RIGHT].push(r, samples);
+                if (demand & AD_WAVEFORM)
+                {
+                    // Capture waveform for left and right
+                    dm->vWaveform[WF_LEFT].push(l, samples);
+                    dm->vWaveform[WF_RIGHT].push(r, samples);
+                    push_wf_peaks(&dm->vWfPeaks[WF_LEFT], l, samples);
+                    push_wf_peaks(&dm->vWfPeaks[WF_RIGHT], r, samples);
+                }
 
-                // Compute stereo panorama
-                dm->sPanometer.process(b1, l, r, samples);
-                dm->vGraphs[DM_PAN].process(b1, samples);
+                if (demand & AD_STEREO)
+                {
+                    // Compute stereo panorama
+                    dm->sPanometer.process(b1, l, r, samples);
+                    dm->vGraphs[DM_PAN].process(b1, samples);
+                }
 
-                // Compute Mid/Side balance
-                dsp::lr_to_ms(b1, b2, l, r, samples);
-                dm->vWaveform[WF_MID].push(b1, samples);
-                dm->vWaveform[WF_SIDE].push(b2, samples);
-                dm->sMsBalance.process(b1, b1, b2, samples);
-                dm->vGraphs[DM_MSBAL].process(b1, samples);
+                if (demand & (AD_WAVEFORM | AD_STEREO))
+                {
+                    // Compute Mid/Side balance
+                    dsp::lr_to_ms(b1, b2, l, r, samples);
+                    if (demand & AD_WAVEFORM)
+                    {
+                        dm->vWaveform[WF_MID].push(b1, samples);
+                        dm->vWaveform[WF_SIDE].push(b2, samples);
+                        push_wf_peaks(&dm->vWfPeaks[WF_MID], b1, samples);
+                        push_wf_peaks(&dm->vWfPeaks[WF_SIDE], b2, samples);
+                    }
+                    if (demand & AD_STEREO)
+                    {
+                        dm->sMsBalance.process(b1, b1, b2, samples);
+                        dm->vGraphs[DM_MSBAL].process(b1, samples);
+                    }
+                }
 
                 // Compute Peak values
                 dsp::pamax3(b1, l, r, samples);
@@ -2026,85 +4678,149 @@ namespace lsp
                 dm->vPeaks[PK_PEAK].process(b1, samples);
 
                 // Compute True Peak values
-                dm->sTPMeter[0].process(b1, l, samples);
-                dm->sTPMeter[1].process(b2, r, samples);
-                dsp::pmax2(b1, b2, samples);
+                if (!(dm->nTimeline & TM_SKIP))
+                {
+                    dm->sTPMeter[0].process(b1, l, samples);
+                    dm->sTPMeter[1].process(b2, r, samples);
+                    dsp::pmax2(b1, b2, samples);
+                }
+                if (dm->nTimeline & TM_SHOW)
+                    dsp::copy(b1, vTimeline[TL_TRUE_PEAK], samples);
                 dm->vGraphs[DM_TRUE_PEAK].process(b1, samples);
                 dm->vPeaks[PK_TRUE_PEAK].process(b1, samples);
 
-                dm->sPSRDelay.process(b1, b1, samples);
+                if (demand & AD_LOUDNESS)
+                {
+                    dm->sPSRDelay.process(b1, b1, samples);
+
+                    // Compute RMS values
+                    dm->sRMSMeter.process(b2, const_cast<const float **>(in), samples);
+                    dm->vGraphs[DM_RMS].process(b2, samples);
+                }
 
-                // Compute RMS values
-                dm->sRMSMeter.process(b2, const_cast<const float **>(in), samples);
-                dm->vGraphs[DM_RMS].process(b2, samples);
+                if (demand & AD_STEREO)
+                {
+                    // Compute correlation between channels
+                    dm->sCorrMeter.process(b2, l, r, samples);
+                    dm->vGraphs[DM_CORR].process(b2, samples);
+                }
 
-                // Compute correlation between channels
-                dm->sCorrMeter.process(b2, l, r, samples);
-                dm->vGraphs[DM_CORR].process(b2, samples);
+                // Apply K-weighting once for all loudness meters
+                dm->sKFilter[0].process(kl, l, samples);
+                dm->sKFilter[1].process(kr, r, samples);
 
-                // Compute Momentary LUFS value
-                dm->sMLUFSMeter.bind(0, NULL, l, 0);
-                dm->sMLUFSMeter.bind(1, NULL, r, 0);
-                dm->sMLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                dm->vGraphs[DM_M_LUFS].process(b2, samples);
+                if (demand & AD_LOUDNESS)
+                {
+                    // Compute Momentary LUFS value
+                    if (!(dm->nTimeline & TM_SKIP))
+                    {
+                        dm->sMLUFSMeter.bind(0, NULL, kl, 0);
+                        dm->sMLUFSMeter.bind(1, NULL, kr, 0);
+                        dm->sMLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                    }
+                    if (dm->nTimeline & TM_SHOW)
+                        dsp::copy(b2, vTimeline[TL_M_LUFS], samples);
+                    dm->vGraphs[DM_M_LUFS].process(b2, samples);
+                }
 
                 // Compute Long-term LUFS value
-                dm->sLLUFSMeter.bind(0, l);
-                dm->sLLUFSMeter.bind(1, r);
+                dm->sLLUFSMeter.bind(0, kl);
+                dm->sLLUFSMeter.bind(1, kr);
                 dm->sLLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
                 dm->vGraphs[DM_L_LUFS].process(b2, samples);
 
                 // Compute Integrated LUFS value
-                dm->sILUFSMeter.bind(0, l);
-                dm->sILUFSMeter.bind(1, r);
+                dm->sILUFSMeter.bind(0, kl);
+                dm->sILUFSMeter.bind(1, kr);
                 dm->sILUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
                 dm->vGraphs[DM_I_LUFS].process(b2, samples);
 
-                // Compute Short-term LUFS value
-                dm->sSLUFSMeter.bind(0, NULL, l, 0);
-                dm->sSLUFSMeter.bind(1, NULL, r, 0);
-                dm->sSLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                dm->vGraphs[DM_S_LUFS].process(b2, samples);
+                if (demand & AD_LOUDNESS)
+                {
+                    // Compute Short-term LUFS value
+                    if (!(dm->nTimeline & TM_SKIP))
+                    {
+                        dm->sSLUFSMeter.bind(0, NULL, kl, 0);
+                        dm->sSLUFSMeter.bind(1, NULL, kr, 0);
+                        dm->sSLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                    }
+                    if (dm->nTimeline & TM_SHOW)
+                        dsp::copy(b2, vTimeline[TL_S_LUFS], samples);
+                    dm->vGraphs[DM_S_LUFS].process(b2, samples);
+                }
             }
             else
             {
-                // Capture waveform
-                dm->vWaveform[WF_LEFT].push(l, samples);
+                if (demand & AD_WAVEFORM)
+                {
+                    // Capture waveform
+                    dm->vWaveform[WF_LEFT].push(l, samples);
+                    push_wf_peaks(&dm->vWfPeaks[WF_LEFT], l, samples);
+                }
 
                 // Compute True Peak values
-                dm->sTPMeter[0].process(b1, l, samples);
+                if (!(dm->nTimeline & TM_SKIP))
+                    dm->sTPMeter[0].process(b1, l, samples);
+                if (dm->nTimeline & TM_SHOW)
+                    dsp::copy(b1, vTimeline[TL_TRUE_PEAK], samples);
                 dm->vGraphs[DM_TRUE_PEAK].process(b1, samples);
 
                 // Compute Peak values
                 dsp::abs2(b1, l, samples);
                 dm->vGraphs[DM_PEAK].process(b1, samples);
-                dm->sPSRDelay.process(b1, b1, samples);
 
-                // Compute RMS values
-                dm->sRMSMeter.process(b2, const_cast<const float **>(in), samples);
-                dm->vGraphs[DM_RMS].process(b2, samples);
+                if (demand & AD_LOUDNESS)
+                {
+                    dm->sPSRDelay.process(b1, b1, samples);
+
+                    // Compute RMS values
+                    dm->sRMSMeter.process(b2, const_cast<const float **>(in), samples);
+                    dm->vGraphs[DM_RMS].process(b2, samples);
+                }
+
+                // Apply K-weighting once for all loudness meters
+                dm->sKFilter[0].process(kl, l, samples);
 
-                // Compute Momentary LUFS value
-                dm->sMLUFSMeter.bind(0, NULL, l, 0);
-                dm->sMLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                dm->vGraphs[DM_M_LUFS].process(b2, samples);
+                if (demand & AD_LOUDNESS)
+                {
+                    // Compute Momentary LUFS value
+                    if (!(dm->nTimeline & TM_SKIP))
+                    {
+                        dm->sMLUFSMeter.bind(0, NULL, kl, 0);
+                        dm->sMLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                    }
+                    if (dm->nTimeline & TM_SHOW)
+                        dsp::copy(b2, vTimeline[TL_M_LUFS], samples);
+                    dm->vGraphs[DM_M_LUFS].process(b2, samples);
+                }
 
                 // Compute Long-term LUFS value
-                dm->sLLUFSMeter.bind(0, l);
+                dm->sLLUFSMeter.bind(0, kl);
                 dm->sLLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
                 dm->vGraphs[DM_L_LUFS].process(b2, samples);
 
                 // Compute Integrated LUFS value
-                dm->sILUFSMeter.bind(0, l);
+                dm->sILUFSMeter.bind(0, kl);
                 dm->sILUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
                 dm->vGraphs[DM_I_LUFS].process(b2, samples);
 
-                // Compute Short-term LUFS value
-                dm->sSLUFSMeter.bind(0, NULL, l, 0);
-                dm->sSLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                dm->vGraphs[DM_S_LUFS].process(b2, samples);
+                if (demand & AD_LOUDNESS)
+                {
+                    // Compute Short-term LUFS value
+                    if (!(dm->nTimeline & TM_SKIP))
+                    {
+                        dm->sSLUFSMeter.bind(0, NULL, kl, 0);
+                        dm->sSLUFSMeter.process(b2, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                    }
+                    if (dm->nTimeline & TM_SHOW)
+                        dsp::copy(b2, vTimeline[TL_S_LUFS], samples);
+                    dm->vGraphs[DM_S_LUFS].process(b2, samples);
+                }
             }
 
+            if (!(demand & AD_LOUDNESS))
+                return;
+
             // Now b1 contains Sample Peak value and b2 contains short-term LUFS value
             // Compute the PSR value as 'Peak / Short-Term LUFS' as defined in AES 143 EB 373:
             // "We propose that the PSR of an audio track be
@@ -2128,18 +4844,24 @@ namespace lsp
             //  that the audio is more “crushed” (i.e. that the
             //  short-­term loudness has been pushed closer to the
             //  Sample Peak value, often by limiting or clipping)".
+            //
+            // The peak decay is a recurrence and is computed sequentially, the logarithm
+            // is the most expensive part and is computed for the whole block at once.
+            double level        = dm->fPSRLevel;
             for (size_t i=0; i<samples; ++i)
             {
-                const float peak    = lsp_max(double(b1[i]), dm->fPSRLevel * fPSRDecay);
                 const float lufs    = b2[i];
+                level               = lsp_max(double(b1[i]), level * fPSRDecay);
 
-                const float psr     = (lufs >= GAIN_AMP_M_72_DB) ? peak / lufs : GAIN_AMP_M_3_DB;
-                const float psr_db  = dspu::gain_to_db(lsp_max(psr, 0.0f));
+                const float psr     = (lufs >= GAIN_AMP_M_72_DB) ? float(level) / lufs : GAIN_AMP_M_3_DB;
 
                 b1[i]               = psr;
-                b2[i]               = psr_db;
-                dm->fPSRLevel       = peak;
+                b2[i]               = lsp_max(psr, GAIN_AMP_M_72_DB);
             }
+            dm->fPSRLevel       = level;
+
+            dsp::logd1(b2, samples);
+            dsp::mul_k2(b2, 20.0f, samples);
 
             dm->vGraphs[DM_PSR].process(b1, samples);
             dm->sPSRStats.process(b2, samples);
@@ -2150,7 +4872,9 @@ namespace lsp
             const float *l, const float *r,
             size_t samples)
         {
-            // Check that stream is present
+            // Check that goniometer is displayed and stream is present
+            if (!(dm->nDemand & AD_GONIOMETER))
+                return;
             if (dm->pGoniometer == NULL)
                 return;
             plug::stream_t *stream = dm->pGoniometer->buffer<plug::stream_t>();
@@ -2226,39 +4950,44 @@ namespace lsp
             float *src          = src_dm->vLoudness;
             float *dst          = dst_dm->vLoudness;
 
-            if (nGainMatching == MATCH_NONE)
+            // The loudness is measured over a long period and changes slowly, so the gain
+            // is computed once per control step and linearly interpolated between steps
+            for (size_t offset=0; offset < samples; )
             {
-                for (size_t i=0; i<samples; ++i)
+                const size_t count  = lsp_min(samples - offset, meta::referencer::AUTOGAIN_STEP);
+                const size_t last   = offset + count - 1;
+                float grow          = fGainMatchGrow;
+                float fall          = fGainMatchFall;
+                if (count < meta::referencer::AUTOGAIN_STEP)
                 {
-                    src_gain            = (src_gain > GAIN_AMP_0_DB) ? lsp_max(src_gain * fGainMatchFall, GAIN_AMP_0_DB) : lsp_min(src_gain * fGainMatchGrow, GAIN_AMP_0_DB);
-                    dst_gain            = (dst_gain > GAIN_AMP_0_DB) ? lsp_max(dst_gain * fGainMatchFall, GAIN_AMP_0_DB) : lsp_min(dst_gain * fGainMatchGrow, GAIN_AMP_0_DB);
-
-                    // Store values to resulting arrays
-                    src[i]              = src_gain;
-                    dst[i]              = dst_gain;
+                    const float k       = fGainMatchRate * count;
+                    grow                = expf(k);
+                    fall                = expf(-k);
                 }
-            }
-            else
-            {
-                for (size_t i=0; i<samples; ++i)
-                {
-                    // Normalize source gain if needed
-                    src_gain            = (src_gain > GAIN_AMP_0_DB) ? lsp_max(src_gain * fGainMatchFall, GAIN_AMP_0_DB) : lsp_min(src_gain * fGainMatchGrow, GAIN_AMP_0_DB);
 
-                    // Compute destination gain
-                    if (dst[i] >= GAIN_AMP_M_60_DB)
-                    {
-                        const float src_loud= src[i] * src_gain;
-                        const float dst_loud= dst[i] * dst_gain;
-                        dst_gain            = (dst_loud > src_loud) ? dst_gain * fGainMatchFall : dst_gain * fGainMatchGrow;
-                    }
-                    else
-                        dst_gain            = lsp_min(dst_gain * fGainMatchGrow, GAIN_AMP_0_DB);
+                // Normalize source gain if needed
+                const float src_next= (src_gain > GAIN_AMP_0_DB) ? lsp_max(src_gain * fall, GAIN_AMP_0_DB) : lsp_min(src_gain * grow, GAIN_AMP_0_DB);
 
-                    // Store values to resulting arrays
-                    src[i]              = src_gain;
-                    dst[i]              = dst_gain;
+                // Compute destination gain
+                float dst_next;
+                if (nGainMatching == MATCH_NONE)
+                    dst_next            = (dst_gain > GAIN_AMP_0_DB) ? lsp_max(dst_gain * fall, GAIN_AMP_0_DB) : lsp_min(dst_gain * grow, GAIN_AMP_0_DB);
+                else if (dst[last] >= GAIN_AMP_M_60_DB)
+                {
+                    const float src_loud= src[last] * src_next;
+                    const float dst_loud= dst[last] * dst_gain;
+                    dst_next            = (dst_loud > src_loud) ? dst_gain * fall : dst_gain * grow;
                 }
+                else
+                    dst_next            = lsp_min(dst_gain * grow, GAIN_AMP_0_DB);
+
+                // Store interpolated values to resulting arrays
+                dsp::lramp_set1(&src[offset], src_gain, src_next, count);
+                dsp::lramp_set1(&dst[offset], dst_gain, dst_next, count);
+
+                src_gain            = src_next;
+                dst_gain            = dst_next;
+                offset             += count;
             }
 
             // Store new values
@@ -2283,57 +5012,230 @@ namespace lsp
             }
         }
 
+        void referencer::capture_analysis_data(size_t samples)
+        {
+            // Drop the data if the analysis task can not keep up with the audio stream. The analysis data
+            // is owned by the analysis task at this moment, so the block can not be analyzed in place
+            if ((nCaptureFill + samples) > ANALYSIS_BUFFER_SIZE)
+            {
+                // Cumulative meters miss the dropped data, reset them instead of showing invalid values
+                ++nCaptureOverruns;
+                nAnalysisFlags         |= AU_SETTINGS | AU_RESET_LLUFS | AU_RESET_ILUFS | AU_RESET_PSR;
+                sOverrun.blink();
+                return;
+            }
+
+            for (size_t offset = 0; offset < samples; )
+            {
+                const size_t to_do      = lsp_min(samples - offset, ANALYSIS_BUFFER_SIZE - nCaptureHead);
+
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c            = &vChannels[i];
+                    dsp::copy(&c->vCapture[0][nCaptureHead], &c->vInBuffer[offset], to_do);
+                    dsp::copy(&c->vCapture[1][nCaptureHead], &c->vBuffer[offset], to_do);
+                }
+
+                nCaptureHead            = (nCaptureHead + to_do) % ANALYSIS_BUFFER_SIZE;
+                nCaptureFill           += to_do;
+                offset                 += to_do;
+            }
+        }
+
+        bool referencer::analysis_idle() const
+        {
+            return (pAnalyzer->idle()) && (pRefAnalyzer->idle());
+        }
+
+        bool referencer::acquire_analysis()
+        {
+            if (!analysis_idle())
+            {
+                // The mix analysis could not be submitted together with the reference analysis
+                if ((pAnalyzer->idle()) && (nAnalysisCount > 0))
+                {
+                    pExecutor->submit(pAnalyzer);
+                    return false;
+                }
+
+                // The analysis data is owned by the analysis tasks until all of them complete
+                if ((!pAnalyzer->idle()) && (!pAnalyzer->completed()))
+                    return false;
+                if ((!pRefAnalyzer->idle()) && (!pRefAnalyzer->completed()))
+                    return false;
+
+                // Release the analyzed data
+                nCaptureTail            = (nCaptureTail + nAnalysisCount) % ANALYSIS_BUFFER_SIZE;
+                nCaptureFill           -= nAnalysisCount;
+                nAnalysisCount          = 0;
+                if (pAnalyzer->completed())
+                    pAnalyzer->reset();
+                if (pRefAnalyzer->completed())
+                    pRefAnalyzer->reset();
+            }
+
+            // Apply deferred changes
+            if (nAnalysisFlags != 0)
+                update_analysis();
+
+            return true;
+        }
+
+        void referencer::submit_analysis()
+        {
+            // Drop the captured data if analysis is performed in the audio thread
+            if (nAnalysisMode == AM_INLINE)
+            {
+                nCaptureTail            = nCaptureHead;
+                nCaptureFill            = 0;
+                return;
+            }
+
+            if (nCaptureFill <= 0)
+                return;
+
+            nAnalysisCount          = nCaptureFill;
+            if (nAnalysisMode == AM_PARALLEL)
+            {
+                // Separate tasks analyze mix and reference, the submission of the mix task
+                // is retried at the next cycle if it fails
+                pRefAnalyzer->set_chains(1, 1);
+                if (pExecutor->submit(pRefAnalyzer))
+                {
+                    pAnalyzer->set_chains(0, 1);
+                    pExecutor->submit(pAnalyzer);
+                    return;
+                }
+            }
+
+            // Single task analyzes both mix and reference, also if the reference task can not be submitted
+            pAnalyzer->set_chains(0, 2);
+            if (!pExecutor->submit(pAnalyzer))
+                nAnalysisCount          = 0;
+        }
+
+        void referencer::perform_background_analysis(size_t first, size_t count)
+        {
+            const size_t samples    = nAnalysisCount;
+            const size_t last       = first + count;
+            size_t tail             = nCaptureTail;
+
+            for (size_t offset = 0; offset < samples; )
+            {
+                const size_t to_do      = lsp_min(samples - offset, ANALYSIS_BUFFER_SIZE - tail, BUFFER_SIZE);
+
+                for (size_t i=first; i<last; ++i)
+                {
+                    const float *l          = &vChannels[0].vCapture[i][tail];
+                    const float *r          = (nChannels > 1) ? &vChannels[1].vCapture[i][tail] : NULL;
+
+                    perform_metering(&vDynaMeters[i], l, r, to_do);
+                    if (vDynaMeters[i].nDemand & AD_SPECTRUM)
+                        perform_fft_analysis(&vFftMeters[i], l, r, to_do);
+                }
+
+                tail                    = (tail + to_do) % ANALYSIS_BUFFER_SIZE;
+                offset                 += to_do;
+            }
+        }
+
         void referencer::process(size_t samples)
         {
+            const wsize_t started       = profile_begin();
+
             preprocess_audio_channels();
             process_file_requests();
 
+            // The analysis can be performed in-place only if it is not owned by the analysis task
+            const bool inline_analysis  = (nAnalysisMode == AM_INLINE) && (analysis_idle());
+
             for (size_t offset = 0; offset < samples; )
             {
                 const size_t to_process = lsp_min(samples - offset, BUFFER_SIZE);
+                wsize_t time            = profile_begin();
 
+                // The timeline is fetched before the loop positions are advanced by the playback
+                uint32_t timeline       = TM_NONE;
+                if ((inline_analysis) && (!bFreeze))
+                    timeline                = fetch_reference_timeline(to_process);
+                else
+                    pTimelineLoop           = NULL;
                 prepare_reference_signal(to_process);
+                time                    = profile_end(PS_PREPARE_REFERENCE, time);
                 apply_gain_matching(to_process);
+                if (timeline & TM_SHOW)
+                {
+                    for (size_t i=0; i<TL_TOTAL; ++i)
+                        dsp::mul2(vTimeline[i], vDynaMeters[1].vLoudness, to_process);
+                }
+                // The live meters were not fed while skipped and hold the outdated state
+                if ((vDynaMeters[1].nTimeline & TM_SKIP) && (!(timeline & TM_SKIP)))
+                    clear_timeline_meters(&vDynaMeters[1]);
+                vDynaMeters[1].nTimeline    = timeline;
+                time                    = profile_end(PS_GAIN_MATCHING, time);
                 apply_pre_filters(to_process);
+                time                    = profile_end(PS_PRE_FILTERS, time);
 
                 // Measure input and reference signal parameters
                 if (!bFreeze)
                 {
-                    perform_metering(
-                        &vDynaMeters[0],
-                        vChannels[0].vInBuffer,
-                        (nChannels > 1) ? vChannels[1].vInBuffer : NULL,
-                        to_process);
+                    if (inline_analysis)
+                    {
+                        perform_metering(
+                            &vDynaMeters[0],
+                            vChannels[0].vInBuffer,
+                            (nChannels > 1) ? vChannels[1].vInBuffer : NULL,
+                            to_process);
+                        time                    = profile_end(PS_METERING, time);
+                        if (vDynaMeters[0].nDemand & AD_SPECTRUM)
+                            perform_fft_analysis(
+                                &vFftMeters[0],
+                                vChannels[0].vInBuffer,
+                                (nChannels > 1) ? vChannels[1].vInBuffer : NULL,
+                                to_process);
+                        time                    = profile_end(PS_FFT_ANALYSIS, time);
+
+                        perform_metering(
+                            &vDynaMeters[1],
+                            vChannels[0].vBuffer,
+                            (nChannels > 1) ? vChannels[1].vBuffer : NULL,
+                            to_process);
+                        time                    = profile_end(PS_METERING, time);
+                        if (vDynaMeters[1].nDemand & AD_SPECTRUM)
+                            perform_fft_analysis(
+                                &vFftMeters[1],
+                                vChannels[0].vBuffer,
+                                (nChannels > 1) ? vChannels[1].vBuffer : NULL,
+                                to_process);
+                        time                    = profile_end(PS_FFT_ANALYSIS, time);
+                    }
+                    else
+                    {
+                        capture_analysis_data(to_process);
+                        time                    = profile_end(PS_CAPTURE, time);
+                    }
+
+                    // Goniometer writes stream ports and is always processed in the audio thread
                     if (nChannels > 1)
+                    {
                         process_goniometer(
                             &vDynaMeters[0],
                             vChannels[0].vInBuffer, vChannels[1].vInBuffer,
                             to_process);
-                    perform_fft_analysis(
-                        &vFftMeters[0],
-                        vChannels[0].vInBuffer,
-                        (nChannels > 1) ? vChannels[1].vInBuffer : NULL,
-                        to_process);
-
-                    perform_metering(
-                        &vDynaMeters[1],
-                        vChannels[0].vBuffer,
-                        (nChannels > 1) ? vChannels[1].vBuffer : NULL,
-                        to_process);
-                    if (nChannels > 1)
                         process_goniometer(
                             &vDynaMeters[1],
                             vChannels[0].vBuffer, vChannels[1].vBuffer,
                             to_process);
-                    perform_fft_analysis(
-                        &vFftMeters[1],
-                        vChannels[0].vBuffer,
-                        (nChannels > 1) ? vChannels[1].vBuffer : NULL,
-                        to_process);
+                        time                    = profile_end(PS_GONIOMETER, time);
+                    }
                 }
 
+                const wsize_t mix_start = time;
                 mix_channels(to_process);
+                time                    = profile_begin();
+                const wsize_t mix_time  = time - mix_start;
                 apply_post_filters(to_process);
+                time                    = profile_end(PS_POST_FILTERS, time);
 
                 if (nChannels > 1)
                     apply_stereo_mode(to_process);
@@ -2347,18 +5249,123 @@ namespace lsp
                     c->vIn             += to_process;
                     c->vOut            += to_process;
                 }
+                // Mixing is split by post-filters, record it once to get the proper peak time
+                profile_end(PS_MIX, time - mix_time);
 
                 offset             += to_process;
             }
 
+            wsize_t time        = profile_begin();
             output_file_data();
             output_loop_data();
-            output_waveform_meshes();
-            output_dyna_meters();
-            output_dyna_meshes();
-            output_psr_mesh();
-            for (size_t i=0; i<FT_TOTAL; ++i)
-                output_spectrum_analysis(i);
+            profile_end(PS_OUTPUT, time);
+            process_stream_requests();
+            pAnalysisOverrun->set_value(sOverrun.process(samples));
+
+            // Output analysis data only if it is not owned by the analysis task
+            if (acquire_analysis())
+            {
+                // Do not output meshes for the analysis that is not performed or if there is no UI
+                const uint32_t demand   = (ui_active()) ? vDynaMeters[0].nDemand | vDynaMeters[1].nDemand : uint32_t(AD_NONE);
+
+                time                = profile_begin();
+                if (demand & AD_WAVEFORM)
+                    output_waveform_meshes();
+                output_dyna_meters();
+                if (ui_active())
+                    output_dyna_meshes();
+                if (nMeshDemand & AD_LOUDNESS)
+                    output_psr_mesh();
+                if (demand & AD_SPECTRUM)
+                {
+                    for (size_t i=0; i<FT_TOTAL; ++i)
+                        output_spectrum_analysis(i);
+                }
+                pFftVMarkVal->set_value(fFftVMarkVal);
+                profile_end(PS_OUTPUT, time);
+
+                submit_analysis();
+            }
+
+            profile_end(PS_PROCESS, started);
+            update_profile(samples);
+        }
+
+        wsize_t referencer::profile_begin() const
+        {
+            if (!bProfiling)
+                return 0;
+
+            // Use the monotonic clock, the wall clock may be adjusted while measuring
+        #ifdef PLATFORM_WINDOWS
+            LARGE_INTEGER freq, counter;
+            ::QueryPerformanceFrequency(&freq);
+            ::QueryPerformanceCounter(&counter);
+            return (wsize_t(counter.QuadPart) / freq.QuadPart) * 1000000000 +
+                ((wsize_t(counter.QuadPart) % freq.QuadPart) * 1000000000) / freq.QuadPart;
+        #else
+            struct timespec ts;
+            ::clock_gettime(CLOCK_MONOTONIC, &ts);
+            return wsize_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        wsize_t referencer::profile_end(size_t stage, wsize_t start)
+        {
+            if (!bProfiling)
+                return 0;
+
+            const wsize_t now   = profile_begin();
+            const wsize_t time  = now - start;
+            profile_t *p        = &vProfile[stage];
+
+            p->nTime           += time;
+            p->nPeak            = lsp_max(p->nPeak, time);
+
+            return now;
+        }
+
+        void referencer::reset_profile()
+        {
+            nProfCounter        = 0;
+
+            for (size_t i=0; i<PS_TOTAL; ++i)
+            {
+                profile_t *p        = &vProfile[i];
+
+                p->nTime            = 0;
+                p->nPeak            = 0;
+                p->fLoad            = 0.0f;
+                p->fPeak            = 0.0f;
+                if (p->pLoad != NULL)
+                    p->pLoad->set_value(0.0f);
+            }
+        }
+
+        void referencer::update_profile(size_t samples)
+        {
+            if (!bProfiling)
+                return;
+
+            nProfCounter       += samples;
+            if (nProfCounter < nProfPeriod)
+                return;
+
+            // Compute the load relatively to the real time of the processed audio
+            const double period = (double(nProfCounter) * 1e+9) / fSampleRate;
+            for (size_t i=0; i<PS_TOTAL; ++i)
+            {
+                profile_t *p        = &vProfile[i];
+
+                p->fLoad            = (double(p->nTime) * 100.0) / period;
+                p->fPeak            = double(p->nPeak) * 1e-3;
+                p->nTime            = 0;
+                p->nPeak            = 0;
+                if (p->pLoad != NULL)
+                    p->pLoad->set_value(p->fLoad);
+            }
+
+            nProfCounter        = 0;
         }
 
         void referencer::output_dyna_meters()
@@ -2530,7 +5537,7 @@ namespace lsp
 
                     t       = mesh->pvData[rows++];
 
-                    copy_waveform(&t[2], rb, frame_off, frame_len, meta::referencer::WAVE_MESH_SIZE);
+                    copy_waveform(&t[2], rb, &dm->vWfPeaks[j], frame_off, frame_len, meta::referencer::WAVE_MESH_SIZE);
 
                     t[0]    = 0.0f;
                     t[1]    = t[2];
@@ -2644,6 +5651,15 @@ namespace lsp
                 afile_t *af         = &vSamples[i];
                 af->bSync           = true;
             }
+
+            // Resume the analysis required for the displayed section
+            request_analysis_demand(true);
+        }
+
+        void referencer::ui_deactivated()
+        {
+            // Suspend the analysis which is only displayed
+            request_analysis_demand(false);
         }
 
         void referencer::dump_channels(dspu::IStateDumper *v) const
@@ -2663,6 +5679,7 @@ namespace lsp
                     v->write("vOut", c->vOut);
                     v->write("vBuffer", c->vBuffer);
                     v->write("vInBuffer", c->vInBuffer);
+                    v->writev("vCapture", c->vCapture, 2);
 
                     v->write("pIn", c->pIn);
                     v->write("pOut", c->pOut);
@@ -2698,6 +5715,7 @@ namespace lsp
                     v->write_object("sRMSMeter", &dm->sRMSMeter);
                     v->write_object_array("sTPMeter", dm->sTPMeter, 2);
                     v->write_object("sPSRDelay", &dm->sPSRDelay);
+                    v->write_object_array("sKFilter", dm->sKFilter, 2);
                     v->write_object("sAutogainMeter", &dm->sAutogainMeter);
                     v->write_object("sMLUFSMeter", &dm->sMLUFSMeter);
                     v->write_object("sSLUFSMeter", &dm->sSLUFSMeter);
@@ -2712,9 +5730,13 @@ namespace lsp
                     v->write_object_array("vPeaks", dm->vPeaks, PK_TOTAL);
 
                     v->write("vLoudness", dm->vLoudness);
+                    v->write("vAnBuffer", dm->vAnBuffer);
                     v->write("fGain", dm->fGain);
                     v->write("fPSRLevel", dm->fPSRLevel);
                     v->write("nGonioStrobe", dm->nGonioStrobe);
+                    v->write("nDemand", dm->nDemand);
+                    v->write("nTimeline", dm->nTimeline);
+                    v->write("nNewDemand", dm->nNewDemand);
 
                     v->writev("pMeters", dm->pMeters, DM_TOTAL);
                     v->writev("pPeaks", dm->pPeaks, PK_TOTAL);
@@ -2735,6 +5757,7 @@ namespace lsp
 
                 v->begin_object(fm, sizeof(fft_meters_t));
                 {
+                    v->write("vAnBuffer", fm->vAnBuffer);
                     v->writev("vHistory", fm->vHistory, 2);
                     v->write("nFftPeriod", fm->nFftPeriod);
                     v->write("nFftFrame", fm->nFftFrame);
@@ -2758,6 +5781,26 @@ namespace lsp
             v->end_array();
         }
 
+        void referencer::dump_profile(dspu::IStateDumper *v) const
+        {
+            v->begin_array("vProfile", vProfile, PS_TOTAL);
+            for (size_t i=0; i<PS_TOTAL; ++i)
+            {
+                const profile_t *p      = &vProfile[i];
+
+                v->begin_object(p, sizeof(profile_t));
+                {
+                    v->write("nTime", p->nTime);
+                    v->write("nPeak", p->nPeak);
+                    v->write("fLoad", p->fLoad);
+                    v->write("fPeak", p->fPeak);
+                    v->write("pLoad", p->pLoad);
+                }
+                v->end_object();
+            }
+            v->end_array();
+        }
+
         void referencer::dump(dspu::IStateDumper *v) const
         {
             plug::Module::dump(v);
@@ -2766,6 +5809,7 @@ namespace lsp
             v->write("nPlaySample", nPlaySample);
             v->write("nPlayLoop", nPlayLoop);
             v->write("nGainMatching", nGainMatching);
+            v->write("fGainMatchRate", fGainMatchRate);
             v->write("fGainMatchGrow", fGainMatchGrow);
             v->write("fGainMatchFall", fGainMatchFall);
             v->write("nCrossfadeTime", nCrossfadeTime);
@@ -2775,20 +5819,38 @@ namespace lsp
             v->write("nFftRank", nFftRank);
             v->write("nFftWindow", nFftWindow);
             v->write("nFftEnvelope", nFftEnvelope);
+            v->write("nFftRefresh", nFftRefresh);
             v->write("fFftTau", fFftTau);
             v->write("fFftBal", fFftBal);
             v->write("nFftSrc", nFftSrc);
             v->write("nGonioPeriod", nGonioPeriod);
             v->write("nPsrMode", nPsrMode);
             v->write("nPsrThresh", nPsrThresh);
+            v->write("nAnalysisMode", nAnalysisMode);
+            v->write("nAnalysisFlags", nAnalysisFlags);
+            v->write("nMeshDemand", nMeshDemand);
+            v->write("nCaptureHead", nCaptureHead);
+            v->write("nCaptureTail", nCaptureTail);
+            v->write("nCaptureFill", nCaptureFill);
+            v->write("nAnalysisCount", nAnalysisCount);
+            v->write("nCaptureOverruns", nCaptureOverruns);
+            v->write("nProfPeriod", nProfPeriod);
+            v->write("nProfCounter", nProfCounter);
+            v->write("pTimelineLoop", pTimelineLoop);
+            v->write("nTimelinePos", nTimelinePos);
+            v->write("nTimelineRun", nTimelineRun);
+            v->write("fFftVMarkVal", fFftVMarkVal);
             v->write("fPSRDecay", fPSRDecay);
             v->write("bPlay", bPlay);
             v->write("bSyncLoopMesh", bSyncLoopMesh);
             v->write("bUpdFft", bUpdFft);
             v->write("bFftDamping", bFftDamping);
             v->write("bFreeze", bFreeze);
+            v->write("bProfiling", bProfiling);
+            v->write("bRefTimeline", bRefTimeline);
 
             v->write("vBuffer", vBuffer);
+            v->write("vSeamBuffer", vSeamBuffer);
             v->write("vFftFreqs", vFftFreqs);
             v->write("vFftInds", vFftInds);
             v->write("vFftWindow", vFftWindow);
@@ -2797,15 +5859,29 @@ namespace lsp
 
             dump_channels(v);
             dump_asource(v, "sMix", &sMix);
+            v->write_object("sOverrun", &sOverrun);
             v->write("pExecutor", pExecutor);
+            v->write("pStreamer", pStreamer);
+            v->write("pAnalyzer", pAnalyzer);
+            v->write("pRefAnalyzer", pRefAnalyzer);
             dump_dyna_meters(v);
             dump_fft_meters(v);
+            dump_profile(v);
 
             v->write("pBypass", pBypass);
             v->write("pFreeze", pFreeze);
+            v->write("pAnalysisMode", pAnalysisMode);
+            v->write("pRefTimeline", pRefTimeline);
+            v->write("pAnalysisOverrun", pAnalysisOverrun);
             v->write("pPlay", pPlay);
             v->write("pPlayLoop", pPlayLoop);
             v->write("pSource", pSource);
+            v->write("pSection", pSection);
+            v->write("pMixVisible", pMixVisible);
+            v->write("pRefVisible", pRefVisible);
+            v->write("pRamBudget", pRamBudget);
+            v->write("pCacheBudget", pCacheBudget);
+            v->write("pSampleStorage", pSampleStorage);
             v->write("pLoopMesh", pLoopMesh);
             v->write("pLoopLen", pLoopLen);
             v->write("pLoopPos", pLoopPos);
@@ -2830,6 +5906,7 @@ namespace lsp
             v->write("pFftDamping", pFftDamping);
             v->write("pFftReset", pFftReset);
             v->write("pFftBallistics", pFftBallistics);
+            v->write("pFftRefresh", pFftRefresh);
             v->writev("pFftMesh", pFftMesh, 3);
             v->write("pFftVMarkSrc", pFftVMarkSrc);
             v->write("pFftVMarkFreq", pFftVMarkFreq);
@@ -2838,6 +5915,7 @@ namespace lsp
             v->write("pPsrThreshold", pPsrThreshold);
             v->write("pPsrMesh", pPsrMesh);
             v->write("pPsrDisplay", pPsrDisplay);
+            v->write("pProfiling", pProfiling);
 
             v->write("pData", pData);
         }
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-referencer
+ * Created on: 16 окт 2026 г.
+ *
+ * lsp-plugins-referencer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-referencer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-referencer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/host/offline.h>
+#include <private/meta/referencer.h>
+
+namespace lsp
+{
+    namespace
+    {
+        typedef struct setting_t
+        {
+            const char     *id;
+            float           value;
+        } setting_t;
+
+        /**
+         * Single benchmark case. Each case is a sweep of one parameter over its values,
+         * all other parameters are kept at their defaults.
+         */
+        typedef struct bench_t
+        {
+            size_t              nSampleRate;
+            size_t              nBlockSize;
+            const setting_t    *vSettings;
+            bool                bUI;            // UI is connected, otherwise only host-visible meters are computed
+        } bench_t;
+    } /* namespace */
+} /* namespace lsp */
+
+PTEST_BEGIN("referencer", process, 1, 1)
+
+    void call(const char *plugin_id, const bench_t *b, const meta::plugin_t *meta)
+    {
+        host::OfflineHost p;
+        if (!p.init(meta))
+        {
+            printf("Failed to instantiate plugin %s\n", plugin_id);
+            return;
+        }
+
+        // Configure the plugin, the Overview tab requires all kinds of analysis
+        plug::IPort *section = p.port("section");
+        if (section != NULL)
+            section->set_value(meta::referencer::TAB_OVERVIEW);
+
+        char key[256];
+        int len = snprintf(key, sizeof(key), "%s sr=%d block=%d%s",
+            plugin_id, int(b->nSampleRate), int(b->nBlockSize), (b->bUI) ? "" : " noui");
+
+        for (const setting_t *s = b->vSettings; (s != NULL) && (s->id != NULL); ++s)
+        {
+            plug::IPort *tp = p.port(s->id);
+            if (tp == NULL)
+                continue;
+            tp->set_value(s->value);
+            len += snprintf(&key[len], sizeof(key) - len, " %s=%d", s->id, int(s->value));
+        }
+
+        p.plugin()->set_sample_rate(b->nSampleRate);
+        p.plugin()->activate();
+        if (b->bUI)
+            p.plugin()->activate_ui();
+        p.plugin()->update_settings();
+
+        // Each iteration processes one second of audio, so the number of iterations
+        // per second is the real-time factor of the plugin
+        printf("Testing %s...\n", key);
+        PTEST_LOOP(key,
+            for (size_t offset = 0; offset < b->nSampleRate; offset += b->nBlockSize)
+                p.plugin()->process(lsp_min(b->nSampleRate - offset, b->nBlockSize));
+        );
+
+        if (b->bUI)
+            p.plugin()->deactivate_ui();
+        p.plugin()->deactivate();
+    }
+
+    void sweep(const meta::plugin_t *meta, const char *plugin_id, size_t sample_rate, size_t block_size, const char *id, size_t count)
+    {
+        setting_t s[2];
+        s[1].id         = NULL;
+        s[1].value      = 0.0f;
+
+        for (size_t i=0; i<count; ++i)
+        {
+            s[0].id         = id;
+            s[0].value      = i;
+
+            bench_t b;
+            b.nSampleRate   = sample_rate;
+            b.nBlockSize    = block_size;
+            b.vSettings     = (id != NULL) ? s : NULL;
+            b.bUI           = true;
+
+            call(plugin_id, &b, meta);
+        }
+        PTEST_SEPARATOR;
+    }
+
+    size_t list_size(const meta::plugin_t *meta, const char *id)
+    {
+        for (const meta::port_t *port = meta->ports; port->id != NULL; ++port)
+        {
+            if ((strcmp(port->id, id)) || (port->items == NULL))
+                continue;
+
+            size_t count = 0;
+            while (port->items[count].text != NULL)
+                ++count;
+            return count;
+        }
+        return 0;
+    }
+
+    PTEST_MAIN
+    {
+        static const size_t sample_rates[] = { 44100, 48000, 96000, 192000 };
+        static const size_t block_sizes[] = { 32, 64, 256, 1024, 4096, host::MAX_BLOCK_SIZE };
+        static const size_t DFL_SAMPLE_RATE = 48000;
+        static const size_t DFL_BLOCK_SIZE = 512;
+
+        static const setting_t filter_settings[] =
+        {
+            { "fsel",   4.0f    },      // Mid band
+            { "fmode",  0.0f    },
+            { NULL,     0.0f    }
+        };
+
+        static const meta::plugin_t *metadata[] =
+        {
+            &meta::referencer_mono,
+            &meta::referencer_stereo
+        };
+        static const char *plugin_ids[] =
+        {
+            "mono",
+            "stereo"
+        };
+
+        for (size_t i=0; i<sizeof(metadata)/sizeof(metadata[0]); ++i)
+        {
+            const meta::plugin_t *meta  = metadata[i];
+            const char *plugin_id       = plugin_ids[i];
+
+            // Block sizes
+            for (size_t j=0; j<sizeof(block_sizes)/sizeof(block_sizes[0]); ++j)
+            {
+                bench_t b;
+                b.nSampleRate   = DFL_SAMPLE_RATE;
+                b.nBlockSize    = block_sizes[j];
+                b.vSettings     = NULL;
+                b.bUI           = true;
+                call(plugin_id, &b, meta);
+            }
+            PTEST_SEPARATOR;
+
+            // Sample rates
+            for (size_t j=0; j<sizeof(sample_rates)/sizeof(sample_rates[0]); ++j)
+            {
+                bench_t b;
+                b.nSampleRate   = sample_rates[j];
+                b.nBlockSize    = DFL_BLOCK_SIZE;
+                b.vSettings     = NULL;
+                b.bUI           = true;
+                call(plugin_id, &b, meta);
+            }
+            PTEST_SEPARATOR;
+
+            // FFT ranks, refresh rates, analysis modes and sources
+            sweep(meta, plugin_id, DFL_SAMPLE_RATE, DFL_BLOCK_SIZE, "ffttol", list_size(meta, "ffttol"));
+            sweep(meta, plugin_id, DFL_SAMPLE_RATE, DFL_BLOCK_SIZE, "fftrate", list_size(meta, "fftrate"));
+            sweep(meta, plugin_id, DFL_SAMPLE_RATE, DFL_BLOCK_SIZE, "anmode", list_size(meta, "anmode"));
+            sweep(meta, plugin_id, DFL_SAMPLE_RATE, DFL_BLOCK_SIZE, "source", list_size(meta, "source"));
+
+            // Filter modes, the post-filter should be enabled
+            for (size_t j=0, n=list_size(meta, "fmode"); j<n; ++j)
+            {
+                setting_t s[3];
+                memcpy(s, filter_settings, sizeof(s));
+                s[1].value      = j;
+
+                bench_t b;
+                b.nSampleRate   = DFL_SAMPLE_RATE;
+                b.nBlockSize    = DFL_BLOCK_SIZE;
+                b.vSettings     = s;
+                b.bUI           = true;
+                call(plugin_id, &b, meta);
+            }
+            PTEST_SEPARATOR;
+
+            // Metering and gain matching only: without UI the analysis is limited to host-visible meters
+            for (size_t j=0, n=list_size(meta, "gmmode"); j<n; ++j)
+            {
+                setting_t s[2];
+                s[0].id         = "gmmode";
+                s[0].value      = j;
+                s[1].id         = NULL;
+                s[1].value      = 0.0f;
+
+                bench_t b;
+                b.nSampleRate   = DFL_SAMPLE_RATE;
+                b.nBlockSize    = DFL_BLOCK_SIZE;
+                b.vSettings     = s;
+                b.bUI           = false;
+                call(plugin_id, &b, meta);
+            }
+            PTEST_SEPARATOR;
+        }
+    }
+
+PTEST_END